@@ -0,0 +1,170 @@
+#include "animationdecoder.h"
+
+AnimationDecoder::AnimationDecoder(QObject *parent)
+    : QThread(parent),
+      capacity(2),
+      seekTarget(-1),
+      readerPosition(0),
+      epoch(0),
+      loop(true),
+      stopRequested(false)
+{
+}
+
+AnimationDecoder::~AnimationDecoder() {
+    close();
+}
+
+void AnimationDecoder::open(const QString &path, const QByteArray &format, int startFrame) {
+    close();
+    mPath = path;
+    mFormat = format;
+    seekTarget = qMax(startFrame, 0);
+    readerPosition = 0;
+    seekIndex.clear();
+    stopRequested = false;
+    start(QThread::LowPriority);
+}
+
+void AnimationDecoder::close() {
+    if(isRunning()) {
+        mutex.lock();
+        stopRequested = true;
+        condition.wakeAll();
+        mutex.unlock();
+        wait();
+    }
+    frames.clear();
+}
+
+void AnimationDecoder::seek(int frame) {
+    QMutexLocker locker(&mutex);
+    frames.clear();
+    seekTarget = frame;
+    epoch++;
+    condition.wakeAll();
+}
+
+int AnimationDecoder::position() {
+    QMutexLocker locker(&mutex);
+    return readerPosition;
+}
+
+void AnimationDecoder::setLoop(bool mode) {
+    QMutexLocker locker(&mutex);
+    loop = mode;
+    condition.wakeAll();
+}
+
+bool AnimationDecoder::takeFrame(AnimationFrame &frame) {
+    QMutexLocker locker(&mutex);
+    if(frames.isEmpty())
+        return false;
+    frame = frames.dequeue();
+    condition.wakeAll();
+    return true;
+}
+
+bool AnimationDecoder::snapshot(int frame, AnimationFrame &snapshotFrame, bool &exact) {
+    return seekIndex.lookup(frame, snapshotFrame.image, snapshotFrame.number, snapshotFrame.delay, exact);
+}
+
+void AnimationDecoder::reopen(QImageReader &reader) {
+    reader.setDevice(nullptr);
+    reader.setFileName(mPath);
+    reader.setFormat(mFormat);
+}
+
+bool AnimationDecoder::readFrame(QImageReader &reader, AnimationFrame &frame, int number, bool skip) {
+    if(!reader.read(&frame.image))
+        return false;
+    frame.number = number;
+    frame.delay = reader.nextImageDelay();
+    bool keyframe = seekIndex.isKeyframe(number);
+    // nobody is going to display a skipped frame; only keyframes need the conversion
+    if(skip && !keyframe)
+        return true;
+    // premultiplied argb is what raster pixmaps use internally;
+    // converting here makes QPixmap::fromImage() a no-op on the gui side
+    if(frame.image.hasAlphaChannel())
+        frame.image = frame.image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    else
+        frame.image = frame.image.convertToFormat(QImage::Format_RGB32);
+    // frames we pass through anyway feed the seek index
+    if(keyframe)
+        seekIndex.insert(number, frame.delay, frame.image);
+    return true;
+}
+
+void AnimationDecoder::run() {
+    QImageReader reader;
+    reopen(reader);
+    seekIndex.reset(reader.imageCount(), reader.size());
+    int nextFrame = 0; // frame that the reader will produce next
+    bool atEnd = false;
+    forever {
+        mutex.lock();
+        while(!stopRequested && seekTarget == -1 && (frames.count() >= capacity || (atEnd && !loop)))
+            condition.wait(&mutex);
+        if(stopRequested) {
+            mutex.unlock();
+            break;
+        }
+        int target = seekTarget;
+        seekTarget = -1;
+        readerPosition = nextFrame;
+        quint64 currentEpoch = epoch;
+        mutex.unlock();
+
+        if(target != -1) {
+            atEnd = false;
+            if(target < nextFrame) {
+                reopen(reader);
+                nextFrame = 0;
+            }
+            // QImageReader can only go forward
+            AnimationFrame skipped;
+            bool interrupted = false;
+            while(nextFrame < target) {
+                // give up on this skip as soon as we are closed or seeked elsewhere
+                mutex.lock();
+                interrupted = stopRequested || currentEpoch != epoch;
+                readerPosition = nextFrame;
+                mutex.unlock();
+                if(interrupted || !readFrame(reader, skipped, nextFrame, true))
+                    break;
+                nextFrame++;
+            }
+            if(interrupted)
+                continue;
+        }
+        if(atEnd) { // loop
+            reopen(reader);
+            nextFrame = 0;
+            atEnd = false;
+        }
+
+        AnimationFrame frame;
+        if(!readFrame(reader, frame, nextFrame)) {
+            if(nextFrame == 0) {
+                qDebug() << "[AnimationDecoder] could not read" << mPath << reader.errorString();
+                emit failed();
+                break;
+            }
+            atEnd = true;
+            continue;
+        }
+        nextFrame++;
+
+        mutex.lock();
+        readerPosition = nextFrame;
+        if(currentEpoch == epoch) {
+            // keep the queue within memory limit, but always allow double-buffering
+            qint64 frameBytes = qMax<qint64>(frame.image.sizeInBytes(), 1);
+            capacity = static_cast<int>(qBound<qint64>(2, BUFFER_SIZE_LIMIT / frameBytes, MAX_BUFFERED_FRAMES));
+            frames.enqueue(frame);
+        }
+        mutex.unlock();
+        emit frameAvailable();
+    }
+}
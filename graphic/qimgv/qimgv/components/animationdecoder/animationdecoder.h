@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImageReader>
+#include <QImage>
+#include <QQueue>
+#include <QDebug>
+#include "animationseekindex.h"
+
+struct AnimationFrame {
+    QImage image;
+    int number = -1;
+    int delay = 0;
+};
+
+/* Decodes animation frames ahead of time in a separate thread.
+ * Decoded frames are kept in a small bounded queue; the decoder sleeps
+ * while it is full and wakes up when the viewer takes a frame.
+ * Frames are converted to a pixmap-friendly format here, so the gui
+ * thread only has to wrap them into a QPixmap.
+ */
+class AnimationDecoder : public QThread
+{
+    Q_OBJECT
+public:
+    explicit AnimationDecoder(QObject *parent = nullptr);
+    ~AnimationDecoder();
+
+    // starts decoding from startFrame
+    void open(const QString &path, const QByteArray &format, int startFrame);
+    void close();
+    // drops buffered frames and continues from the specified one
+    void seek(int frame);
+    // frame that the decoder is about to read; seeking behind it restarts the reader
+    int position();
+    void setLoop(bool mode);
+    // non-blocking, returns false if nothing is decoded yet
+    bool takeFrame(AnimationFrame &frame);
+    // closest keyframe snapshot at or before the requested frame
+    bool snapshot(int frame, AnimationFrame &snapshotFrame, bool &exact);
+
+signals:
+    void frameAvailable();
+    // the file can't be decoded; the thread has stopped
+    void failed();
+
+protected:
+    void run() override;
+
+private:
+    QMutex mutex;
+    QWaitCondition condition;
+    QQueue<AnimationFrame> frames;
+    AnimationSeekIndex seekIndex;
+    QString mPath;
+    QByteArray mFormat;
+    int capacity, seekTarget, readerPosition;
+    // bumped on every seek so that an in-flight frame gets discarded
+    quint64 epoch;
+    bool loop, stopRequested;
+
+    bool readFrame(QImageReader &reader, AnimationFrame &frame, int number, bool skip = false);
+    void reopen(QImageReader &reader);
+
+    const int MAX_BUFFERED_FRAMES = 8;
+    const qint64 BUFFER_SIZE_LIMIT = 64 * 1024 * 1024; // bytes
+};
@@ -0,0 +1,108 @@
+#include "animationseekindex.h"
+
+AnimationSeekIndex::AnimationSeekIndex()
+    : snapshotSizeLimit(0),
+      usedBytes(0),
+      interval(KEYFRAME_INTERVAL)
+{
+}
+
+void AnimationSeekIndex::reset(int frameCount, QSize frameSize) {
+    QMutexLocker locker(&mutex);
+    snapshots.clear();
+    usedBytes = 0;
+    interval = KEYFRAME_INTERVAL;
+    mFrameSize = frameSize;
+    int keyframes = (frameCount > 0) ? frameCount / KEYFRAME_INTERVAL + 1 : UNKNOWN_COUNT_KEYFRAMES;
+    snapshotSizeLimit = MEMORY_BUDGET / keyframes;
+}
+
+void AnimationSeekIndex::clear() {
+    QMutexLocker locker(&mutex);
+    snapshots.clear();
+    usedBytes = 0;
+    interval = KEYFRAME_INTERVAL;
+    mFrameSize = QSize();
+    snapshotSizeLimit = 0;
+}
+
+bool AnimationSeekIndex::isKeyframe(int frame) const {
+    return frame % interval == 0;
+}
+
+void AnimationSeekIndex::insert(int frame, int delay, const QImage &image) {
+    qint64 sizeLimit;
+    {
+        QMutexLocker locker(&mutex);
+        if(!isKeyframe(frame) || snapshots.contains(frame) || snapshotSizeLimit <= 0 || image.isNull())
+            return;
+        sizeLimit = snapshotSizeLimit;
+    }
+    Snapshot snapshot;
+    snapshot.delay = delay;
+    snapshot.downsampled = false;
+    if(image.sizeInBytes() <= sizeLimit) {
+        snapshot.image = image; // implicitly shared, no copy
+    } else {
+        // outside of the lock, lookup() on the gui thread would wait for this
+        qreal factor = std::sqrt(static_cast<qreal>(sizeLimit) / image.sizeInBytes());
+        QSize size = (QSizeF(image.size()) * factor).toSize().expandedTo(QSize(1, 1));
+        snapshot.image = image.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        snapshot.downsampled = true;
+    }
+    QMutexLocker locker(&mutex);
+    // reset() / clear() in the meantime
+    if(snapshotSizeLimit != sizeLimit || snapshots.contains(frame))
+        return;
+    mFrameSize = image.size();
+    qint64 bytes = snapshot.image.sizeInBytes();
+    while(usedBytes + bytes > MEMORY_BUDGET) {
+        if(!thinOut())
+            break;
+    }
+    if(!isKeyframe(frame) || usedBytes + bytes > MEMORY_BUDGET)
+        return;
+    snapshots.insert(frame, snapshot);
+    usedBytes += bytes;
+}
+
+// Drops every other snapshot; false if there is nothing left to drop.
+// Call with the mutex held.
+bool AnimationSeekIndex::thinOut() {
+    if(snapshots.count() < 2)
+        return false;
+    interval = interval * 2;
+    for(auto it = snapshots.begin(); it != snapshots.end();) {
+        if(it.key() % interval != 0) {
+            usedBytes -= it.value().image.sizeInBytes();
+            it = snapshots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+bool AnimationSeekIndex::lookup(int frame, QImage &image, int &snapshotFrame, int &delay, bool &exact) {
+    Snapshot snapshot;
+    QSize frameSize;
+    {
+        QMutexLocker locker(&mutex);
+        // first key greater than frame, then step back
+        auto it = snapshots.upperBound(frame);
+        if(it == snapshots.begin())
+            return false;
+        --it;
+        snapshotFrame = it.key();
+        snapshot = it.value(); // implicitly shared, no copy
+        frameSize = mFrameSize;
+    }
+    delay = snapshot.delay;
+    exact = (snapshotFrame == frame && !snapshot.downsampled);
+    // upscale outside of the lock so the decoder is not held up by it
+    if(snapshot.downsampled)
+        image = snapshot.image.scaled(frameSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    else
+        image = snapshot.image;
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QMutex>
+#include <QMap>
+#include <QImage>
+#include <atomic>
+#include <cmath>
+
+/* Periodic frame snapshots used to make scrubbing through long animations
+ * responsive. Every N-th frame which passes through the decoder is stored,
+ * downsampled if necessary. Stored bytes are counted; when they would go
+ * over the memory budget every other snapshot is dropped and N doubles.
+ * Written from the decoder thread, read from gui thread.
+ */
+class AnimationSeekIndex
+{
+public:
+    AnimationSeekIndex();
+    void reset(int frameCount, QSize frameSize);
+    void clear();
+    bool isKeyframe(int frame) const;
+    void insert(int frame, int delay, const QImage &image);
+    // finds the closest snapshot at or before frame; returns it at original size
+    bool lookup(int frame, QImage &image, int &snapshotFrame, int &delay, bool &exact);
+
+private:
+    struct Snapshot {
+        QImage image;
+        int delay;
+        bool downsampled;
+    };
+    QMutex mutex;
+    QMap<int, Snapshot> snapshots;
+    QSize mFrameSize;
+    qint64 snapshotSizeLimit, usedBytes;
+    // read without the lock by isKeyframe()
+    std::atomic<int> interval;
+
+    bool thinOut();
+
+    const int KEYFRAME_INTERVAL = 32;
+    // what the snapshot size is based on when the reader can't tell the frame count
+    const int UNKNOWN_COUNT_KEYFRAMES = 32;
+    const qint64 MEMORY_BUDGET = 96 * 1024 * 1024; // bytes
+};
@@ -22,7 +22,6 @@ bool Cache::insert(std::shared_ptr<Image> img) {
 
 void Cache::remove(QString path) {
     if(items.contains(path)) {
-        items[path]->lock();
         auto *item = items.take(path);
         delete item;
     }
@@ -30,7 +29,6 @@ void Cache::remove(QString path) {
 
 void Cache::clear() {
     for(auto path : items.keys()) {
-        items[path]->lock();
         auto item = items.take(path);
         delete item;
     }
@@ -44,27 +42,10 @@ std::shared_ptr<Image> Cache::get(QString path) {
     return nullptr;
 }
 
-bool Cache::reserve(QString path) {
-    if(items.contains(path)) {
-        items[path]->lock();
-        return true;
-    }
-    return false;
-}
-
-bool Cache::release(QString path) {
-    if(items.contains(path)) {
-        items[path]->unlock();
-        return true;
-    }
-    return false;
-}
-
 // removes all items except the ones in list
 void Cache::trimTo(QStringList pathList) {
     for(auto path : items.keys()) {
         if(!pathList.contains(path)) {
-            items[path]->lock();
             auto *item = items.take(path);
             delete item;
         }
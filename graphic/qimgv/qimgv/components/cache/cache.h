@@ -2,8 +2,6 @@
 
 #include <QDebug>
 #include <QMap>
-#include <QSemaphore>
-#include <QMutexLocker>
 #include "sourcecontainers/image.h"
 #include "components/cache/cacheitem.h"
 #include "utils/imagefactory.h"
@@ -19,8 +17,6 @@ public:
     void trimTo(QStringList list);
 
     std::shared_ptr<Image> get(QString path);
-    bool release(QString path);
-    bool reserve(QString path);
     const QList<QString> keys() const;
 
 private:
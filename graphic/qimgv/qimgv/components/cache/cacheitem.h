@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QSemaphore>
 #include "sourcecontainers/image.h"
 
 class CacheItem {
@@ -11,12 +10,7 @@ public:
 
     std::shared_ptr<Image> getContents();
 
-    void lock();
-    void unlock();
-
-    int lockStatus();
 private:
     std::shared_ptr<Image> contents;
-    QSemaphore *sem;
 };
 
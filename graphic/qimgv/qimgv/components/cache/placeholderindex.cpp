@@ -0,0 +1,212 @@
+#include "placeholderindex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QMap>
+#include <QSaveFile>
+#include <QDebug>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    const quint32 MAGIC = 0x51504c48; // "QPLH"
+    const quint16 VERSION = 1;
+    // rewrite once there are this many more records than entries
+    const int STALE_LIMIT = 1000;
+
+    bool validData(const QByteArray &data) {
+        if(data.size() < 2)
+            return false;
+        int width = static_cast<uchar>(data.at(0));
+        int height = static_cast<uchar>(data.at(1));
+        return width && height && width <= PlaceholderIndex::SIZE && height <= PlaceholderIndex::SIZE &&
+               data.size() == 2 + width * height * 3;
+    }
+}
+
+PlaceholderIndex::PlaceholderIndex(const QString &_filePath, int _maxEntries)
+    : filePath(_filePath),
+      maxEntries(_maxEntries),
+      loaded(false),
+      records(0),
+      clock(0)
+{
+}
+
+void PlaceholderIndex::preload() {
+    if(loaded)
+        return;
+    QMutexLocker fileLocker(&fileMutex);
+    if(!loaded) {
+        load();
+        loaded = true;
+    }
+}
+
+QImage PlaceholderIndex::get(const QString &path) {
+    QByteArray key = keyOf(path);
+    QMutexLocker locker(&mutex);
+    auto entry = entries.constFind(key);
+    if(entry == entries.constEnd())
+        return QImage();
+    const QByteArray &data = entry->data;
+    int width = static_cast<uchar>(data.at(0));
+    int height = static_cast<uchar>(data.at(1));
+    QImage image(reinterpret_cast<const uchar*>(data.constData() + 2), width, height, width * 3, QImage::Format_RGB888);
+    // detach from the hash's buffer
+    return image.copy();
+}
+
+bool PlaceholderIndex::contains(const QString &path) {
+    preload();
+    QMutexLocker locker(&mutex);
+    return entries.contains(keyOf(path));
+}
+
+void PlaceholderIndex::insert(const QString &path, const QImage &placeholder) {
+    if(placeholder.isNull() || placeholder.width() > SIZE || placeholder.height() > SIZE)
+        return;
+    QImage rgb = placeholder.convertToFormat(QImage::Format_RGB888);
+    QByteArray data;
+    data.reserve(2 + rgb.width() * rgb.height() * 3);
+    data.append(static_cast<char>(rgb.width()));
+    data.append(static_cast<char>(rgb.height()));
+    for(int y = 0; y < rgb.height(); y++)
+        data.append(reinterpret_cast<const char*>(rgb.constScanLine(y)), rgb.width() * 3);
+
+    preload();
+    QByteArray key = keyOf(path);
+    QMutexLocker fileLocker(&fileMutex);
+    bool rewriteNeeded;
+    {
+        QMutexLocker locker(&mutex);
+        auto entry = entries.constFind(key);
+        if(entry != entries.constEnd() && entry->data == data)
+            return;
+        entries.insert(key, Entry { data, ++clock });
+        rewriteNeeded = (records - entries.count() > STALE_LIMIT) ||
+                        (entries.count() > maxEntries + maxEntries / 10);
+    }
+    if(rewriteNeeded)
+        rewrite();
+    else
+        append(key, data);
+}
+
+int PlaceholderIndex::count() {
+    preload();
+    QMutexLocker locker(&mutex);
+    return entries.count();
+}
+
+QImage PlaceholderIndex::make(const QImage &thumbnail, const QSize &originalSize) {
+    if(thumbnail.isNull())
+        return QImage();
+    bool cropped = (thumbnail.width() == thumbnail.height());
+    QSize size = (cropped && originalSize.isValid()) ? originalSize : thumbnail.size();
+    size = size.scaled(SIZE, SIZE, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+    return thumbnail.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                    .convertToFormat(QImage::Format_RGB888);
+}
+
+// call with the file mutex held
+void PlaceholderIndex::load() {
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+        return;
+    QDataStream in(&file);
+    quint32 magic;
+    quint16 version;
+    in >> magic >> version;
+    if(in.status() != QDataStream::Ok || magic != MAGIC || version != VERSION) {
+        qDebug() << "[PlaceholderIndex] ignoring" << filePath;
+        file.close();
+        file.remove();
+        return;
+    }
+    // parsed without the lookup lock, the gui just gets nothing meanwhile
+    QHash<QByteArray, Entry> loadedEntries;
+    quint64 stamp = 0;
+    bool torn = false;
+    QByteArray key, data;
+    while(!in.atEnd()) {
+        in >> key >> data;
+        // torn last record from a crash; keep the rest and
+        // rewrite so that new records don't end up behind it
+        if(in.status() != QDataStream::Ok || !validData(data)) {
+            torn = true;
+            break;
+        }
+        loadedEntries.insert(key, Entry { data, ++stamp });
+        records++;
+    }
+    file.close();
+    {
+        QMutexLocker locker(&mutex);
+        entries.swap(loadedEntries);
+        clock = stamp;
+    }
+    if(torn || entries.count() > maxEntries)
+        rewrite();
+}
+
+// call with the file mutex held
+void PlaceholderIndex::append(const QByteArray &key, const QByteArray &data) {
+    QFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
+    QDataStream out(&file);
+    if(file.size() == 0) {
+        out << MAGIC << VERSION;
+        records = 0;
+    }
+    out << key << data;
+    records++;
+}
+
+// call with the file mutex held; only a snapshot is taken under the lookup lock
+void PlaceholderIndex::rewrite() {
+    QHash<QByteArray, Entry> snapshot;
+    {
+        QMutexLocker locker(&mutex);
+        prune();
+        snapshot = entries;
+    }
+    // oldest first, so that the ages survive a reload
+    QMap<quint64, QByteArray> byAge;
+    for(auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it)
+        byAge.insert(it->stamp, it.key());
+    QSaveFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out << MAGIC << VERSION;
+    for(auto &key : byAge)
+        out << key << snapshot.value(key).data;
+    if(file.commit())
+        records = snapshot.count();
+}
+
+// drops the oldest entries past maxEntries; call with the mutex held
+void PlaceholderIndex::prune() {
+    if(entries.count() <= maxEntries)
+        return;
+    std::vector<quint64> stamps;
+    stamps.reserve(entries.count());
+    for(auto &entry : entries)
+        stamps.push_back(entry.stamp);
+    auto cutoff = stamps.begin() + (entries.count() - maxEntries);
+    std::nth_element(stamps.begin(), cutoff, stamps.end());
+    quint64 oldestKept = *cutoff;
+    for(auto it = entries.begin(); it != entries.end();) {
+        if(it->stamp < oldestKept)
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+QByteArray PlaceholderIndex::keyOf(const QString &path) {
+    return QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Md5);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+/* Tiny colour previews (at most SIZE x SIZE, aspect kept) of images the
+ * thumbnailer has seen, by file path. Thumbnail views draw them until the
+ * real thumbnail arrives, so a freshly opened folder looks filled in at once.
+ *
+ * Everything is kept in memory, about 200 bytes per image, at most
+ * maxEntries of them; the oldest are dropped when the file is rewritten.
+ * The file is append-only: every insert adds a record and on load later
+ * records win. It is rewritten once the stale records pile up.
+ *
+ * Thread safe; thumbnailer threads insert while the gui reads. The gui
+ * never waits for the file: get() has nothing until preload() is done,
+ * which reads it on the calling thread, and file writes happen outside
+ * of the lock get() takes.
+ */
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+class PlaceholderIndex {
+public:
+    explicit PlaceholderIndex(const QString &_filePath, int _maxEntries = MAX_ENTRIES);
+
+    // reads the file; not on the gui thread
+    void preload();
+    // null image if there is none
+    QImage get(const QString &path);
+    // these preload first
+    bool contains(const QString &path);
+    void insert(const QString &path, const QImage &placeholder);
+    int count();
+
+    // downscaled copy of a thumbnail. A square thumbnail may be cropped, its
+    // aspect comes from originalSize, which has to be the exif-rotated size;
+    // any other thumbnail already has the right aspect
+    static QImage make(const QImage &thumbnail, const QSize &originalSize);
+
+    static const int SIZE = 8;
+    // about 10MB
+    static const int MAX_ENTRIES = 50000;
+
+private:
+    struct Entry {
+        // width, height, rgb bytes
+        QByteArray data;
+        // higher is newer
+        quint64 stamp;
+    };
+    // entries & clock; held only for lookups
+    QMutex mutex;
+    // the file & records; taken before mutex, never after
+    QMutex fileMutex;
+    QString filePath;
+    int maxEntries;
+    std::atomic<bool> loaded;
+    // records in the file, stale ones included
+    int records;
+    quint64 clock;
+    // by md5 of the path
+    QHash<QByteArray, Entry> entries;
+
+    void load();
+    void append(const QByteArray &key, const QByteArray &data);
+    void rewrite();
+    void prune();
+    static QByteArray keyOf(const QString &path);
+};
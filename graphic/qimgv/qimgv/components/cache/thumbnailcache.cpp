@@ -36,3 +36,25 @@ QImage *ThumbnailCache::readThumbnail(QString id) {
         return nullptr;
     }
 }
+
+void ThumbnailCache::savePlaceholder(QString path, const QImage &thumbnail, QSize originalSize) {
+    placeholders()->insert(path, PlaceholderIndex::make(thumbnail, originalSize));
+}
+
+QImage ThumbnailCache::readPlaceholder(QString path) {
+    return placeholders()->get(path);
+}
+
+bool ThumbnailCache::hasPlaceholder(QString path) {
+    return placeholders()->contains(path);
+}
+
+void ThumbnailCache::preloadPlaceholders() {
+    placeholders()->preload();
+}
+
+// one index for every ThumbnailCache, they all live in the same directory
+PlaceholderIndex *ThumbnailCache::placeholders() {
+    static PlaceholderIndex index(cacheDirPath + "placeholders");
+    return &index;
+}
@@ -6,6 +6,7 @@
 #include <QDebug>
 #include "settings.h"
 #include "sourcecontainers/thumbnail.h"
+#include "components/cache/placeholderindex.h"
 
 class ThumbnailCache : public QObject
 {
@@ -18,6 +19,13 @@ public:
     QString thumbnailPath(QString id);
     bool exists(QString id);
 
+    // tiny previews by file path, see PlaceholderIndex
+    void savePlaceholder(QString path, const QImage &thumbnail, QSize originalSize);
+    QImage readPlaceholder(QString path);
+    bool hasPlaceholder(QString path);
+    // reads the placeholder file; not on the gui thread
+    void preloadPlaceholders();
+
 signals:
 
 public slots:
@@ -26,4 +34,5 @@ private:
     // we are still bottlenecked by disk access anyway
     QMutex mutex;
     QString cacheDirPath;
+    PlaceholderIndex *placeholders();
 };
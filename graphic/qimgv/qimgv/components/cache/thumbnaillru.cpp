@@ -0,0 +1,150 @@
+#include "thumbnaillru.h"
+
+ThumbnailLru::ThumbnailLru()
+    : clock(0),
+      mBudget(0),
+      used(0),
+      mThumbnailSize(0),
+      visibleFirst(0),
+      visibleLast(-1),
+      keepFirst(0),
+      keepLast(-1),
+      mHits(0),
+      mMisses(0)
+{
+}
+
+void ThumbnailLru::setBudget(qint64 bytes) {
+    mBudget = bytes;
+}
+
+qint64 ThumbnailLru::budget() const {
+    return mBudget;
+}
+
+qint64 ThumbnailLru::usedBytes() const {
+    return used;
+}
+
+int ThumbnailLru::count() const {
+    return entries.count();
+}
+
+bool ThumbnailLru::contains(int index) const {
+    return entries.contains(index);
+}
+
+void ThumbnailLru::setThumbnailSize(int size) {
+    if(mThumbnailSize == size)
+        return;
+    mThumbnailSize = size;
+    clear();
+}
+
+void ThumbnailLru::setWindow(int _visibleFirst, int _visibleLast, int _keepFirst, int _keepLast) {
+    visibleFirst = _visibleFirst;
+    visibleLast = _visibleLast;
+    keepFirst = _keepFirst;
+    keepLast = _keepLast;
+}
+
+std::shared_ptr<Thumbnail> ThumbnailLru::get(int index, bool countMiss) {
+    auto entry = entries.find(index);
+    if(entry == entries.end()) {
+        if(countMiss)
+            mMisses++;
+        return nullptr;
+    }
+    mHits++;
+    order.remove(entry->stamp);
+    entry->stamp = ++clock;
+    order.insert(entry->stamp, index);
+    return entry->thumbnail;
+}
+
+QList<int> ThumbnailLru::insert(int index, std::shared_ptr<Thumbnail> thumbnail, qint64 bytes) {
+    if(!thumbnail || thumbnail->size() != mThumbnailSize)
+        return QList<int>();
+    remove(index);
+    Entry entry { thumbnail, bytes, ++clock };
+    entries.insert(index, entry);
+    order.insert(entry.stamp, index);
+    used += bytes;
+    return trim();
+}
+
+QList<int> ThumbnailLru::trim() {
+    QList<int> evicted;
+    // outside of the window first, then anything that is not visible
+    for(int pass = 0; pass < 2 && used > mBudget; pass++) {
+        for(auto it = order.begin(); it != order.end() && used > mBudget;) {
+            int index = it.value();
+            bool keep = (index >= visibleFirst && index <= visibleLast) ||
+                        (pass == 0 && index >= keepFirst && index <= keepLast);
+            if(keep) {
+                ++it;
+                continue;
+            }
+            used -= entries.take(index).bytes;
+            it = order.erase(it);
+            evicted << index;
+        }
+    }
+    return evicted;
+}
+
+void ThumbnailLru::remove(int index) {
+    auto entry = entries.find(index);
+    if(entry == entries.end())
+        return;
+    used -= entry->bytes;
+    order.remove(entry->stamp);
+    entries.erase(entry);
+}
+
+void ThumbnailLru::clear() {
+    entries.clear();
+    order.clear();
+    used = 0;
+}
+
+void ThumbnailLru::shift(int from, int delta) {
+    QHash<int, Entry> shifted;
+    shifted.reserve(entries.count());
+    order.clear();
+    for(auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        int index = (it.key() >= from) ? it.key() + delta : it.key();
+        shifted.insert(index, it.value());
+        order.insert(it->stamp, index);
+    }
+    entries.swap(shifted);
+}
+
+void ThumbnailLru::reorder(const QList<int> &newIndex) {
+    QHash<int, Entry> moved;
+    moved.reserve(entries.count());
+    order.clear();
+    for(auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        int index = (it.key() < newIndex.count()) ? newIndex.at(it.key()) : -1;
+        if(index < 0) {
+            used -= it->bytes;
+            continue;
+        }
+        moved.insert(index, it.value());
+        order.insert(it->stamp, index);
+    }
+    entries.swap(moved);
+}
+
+quint64 ThumbnailLru::hits() const {
+    return mHits;
+}
+
+quint64 ThumbnailLru::misses() const {
+    return mMisses;
+}
+
+void ThumbnailLru::resetCounters() {
+    mHits = 0;
+    mMisses = 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/* Thumbnails a ThumbnailView has loaded, by item index, kept within a
+ * byte budget.
+ *
+ * Eviction goes from the least recently used entry on, but skips the
+ * window set with setWindow(): the visible items are never dropped, the
+ * rest of the window (preload area, stretched in the scroll direction)
+ * only once nothing outside of it is left.
+ *
+ * Only thumbnails of one pixel size are kept, setThumbnailSize() drops
+ * the others. get() counts hits & misses.
+ */
+
+#include <QHash>
+#include <QMap>
+#include <QList>
+#include <memory>
+#include "sourcecontainers/thumbnail.h"
+
+class ThumbnailLru {
+public:
+    ThumbnailLru();
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+    qint64 usedBytes() const;
+    int count() const;
+    bool contains(int index) const;
+
+    void setThumbnailSize(int size);
+    void setWindow(int visibleFirst, int visibleLast, int keepFirst, int keepLast);
+
+    // nullptr on a miss; a hit becomes the most recently used entry
+    std::shared_ptr<Thumbnail> get(int index, bool countMiss = true);
+    // returns the indices evicted to stay within budget
+    QList<int> insert(int index, std::shared_ptr<Thumbnail> thumbnail, qint64 bytes);
+    QList<int> trim();
+    void remove(int index);
+    void clear();
+    // indices from "from" onward moved by delta
+    void shift(int from, int delta);
+    // items were re-sorted, inserted or removed; entry i moves to newIndex[i],
+    // entries mapped to -1 or past the list are dropped
+    void reorder(const QList<int> &newIndex);
+
+    quint64 hits() const;
+    quint64 misses() const;
+    void resetCounters();
+
+private:
+    struct Entry {
+        std::shared_ptr<Thumbnail> thumbnail;
+        qint64 bytes;
+        quint64 stamp;
+    };
+    QHash<int, Entry> entries;
+    // use stamp -> index, oldest first
+    QMap<quint64, int> order;
+    quint64 clock;
+    qint64 mBudget, used;
+    int mThumbnailSize;
+    int visibleFirst, visibleLast, keepFirst, keepLast;
+    quint64 mHits, mMisses;
+};
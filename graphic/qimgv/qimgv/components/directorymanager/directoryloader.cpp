@@ -0,0 +1,278 @@
+#include "directoryloader.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+#ifdef __linux__
+// layout of the records returned by getdents64
+struct linux_dirent64 {
+    ino64_t        d_ino;
+    off64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    char           d_name[];
+};
+
+// C++17 has no clock_cast; file_time_type epoch is implementation defined
+// but it is always a whole number of seconds away from system_clock
+static fs::file_time_type toFileTime(qint64 sec, quint32 nsec) {
+    using namespace std::chrono;
+    static const seconds clockOffset = round<seconds>(fs::file_time_type::clock::now().time_since_epoch() -
+                                                      system_clock::now().time_since_epoch());
+    auto sinceEpoch = duration_cast<fs::file_time_type::duration>(seconds(sec) + nanoseconds(nsec) + clockOffset);
+    return fs::file_time_type(sinceEpoch);
+}
+#endif
+
+DirectoryLoader::DirectoryLoader(QString _path, bool _recursive, ExtensionFilter _filter, bool _showHidden, bool _needsStat, std::shared_ptr<std::atomic<bool>> _cancelled, quint64 _id)
+    : path(_path),
+      recursive(_recursive),
+      showHidden(_showHidden),
+      needsStat(_needsStat),
+      filter(_filter),
+      cancelled(_cancelled),
+      id(_id),
+      reconciling(false),
+      batchSize(FIRST_BATCH_SIZE)
+{
+    // own instance; must match the settings of DirectoryManager::collator
+    collator.setNumericMode(true);
+}
+
+void DirectoryLoader::setSnapshot(QString _snapshotFile, QByteArray _snapshotSignature) {
+    snapshotFile = _snapshotFile;
+    snapshotSignature = _snapshotSignature;
+}
+
+void DirectoryLoader::run() {
+    batchTimer.start();
+    if(!recursive && !snapshotFile.isEmpty())
+        loadSnapshot();
+    try {
+        if(recursive) { // load files only
+            loadDirectoryRecursive();
+        } else { // load dirs & files
+#ifdef __linux__
+            if(!loadDirectoryLinux())
+#endif
+            loadDirectory();
+        }
+    } catch (const fs::filesystem_error &err) {
+        qDebug() << "[DirectoryLoader]" << err.what();
+    }
+    if(!isCancelled())
+        flush(true);
+    emit finished(id);
+}
+
+bool DirectoryLoader::isCancelled() const {
+    return cancelled && cancelled->load();
+}
+
+bool DirectoryLoader::isHidden(const fs::directory_entry &entry, const QString &name) const {
+#ifndef Q_OS_WIN32
+    Q_UNUSED(entry)
+    return name.startsWith(".");
+#else
+    Q_UNUSED(name)
+    DWORD attributes = GetFileAttributes(entry.path().generic_string().c_str());
+    return attributes & FILE_ATTRIBUTE_HIDDEN;
+#endif
+}
+
+void DirectoryLoader::loadDirectory() {
+    for(const auto & entry : fs::directory_iterator(toStdString(path))) {
+        if(isCancelled())
+            return;
+        QString name = QString::fromStdString(entry.path().filename().generic_string());
+        if(!showHidden && isHidden(entry, name))
+            continue;
+        QString entryPath = QString::fromStdString(entry.path().generic_string());
+        try {
+            if(entry.is_directory()) {
+                setSortKey(dirs.emplace_back(entryPath, name, true));
+            } else if(filter.matches(name)) {
+                setSortKey(files.emplace_back(entryPath, name, entry.file_size(), entry.last_write_time(), false));
+            }
+        } catch (const fs::filesystem_error &err) {
+            qDebug() << "[DirectoryLoader]" << err.what();
+            continue;
+        }
+        flush(false);
+    }
+}
+
+// Subdirectories are listed in parallel by TreeWalker. Only worker 0 (the
+// thread that is running run()) sends batches out; the rest just add to them.
+// That way a blocking load still delivers everything on the caller's thread.
+void DirectoryLoader::loadDirectoryRecursive() {
+    TreeWalker walker([this](int worker, const QString &dirPath, QStringList &subdirs) {
+        return visitDirectory(worker, dirPath, subdirs);
+    });
+    collators.assign(walker.threadCount(), collator);
+    walker.walk(path);
+}
+
+// Lists a single directory for the recursive walk. Subdirectories are
+// passed back up as well, the receiver uses them to set up watches.
+bool DirectoryLoader::visitDirectory(int worker, const QString &dirPath, QStringList &subdirs) {
+    if(isCancelled())
+        return false;
+    std::vector<FSEntry> foundFiles, foundDirs;
+    std::error_code ec;
+    fs::directory_iterator it(toStdString(dirPath), ec), end;
+    if(ec) {
+        qDebug() << "[DirectoryLoader]" << dirPath << ec.message().c_str();
+        return true;
+    }
+    for(; it != end; it.increment(ec)) {
+        if(ec)
+            break;
+        const auto &entry = *it;
+        QString name = QString::fromStdString(entry.path().filename().generic_string());
+        if(!showHidden && isHidden(entry, name))
+            continue;
+        QString entryPath = QString::fromStdString(entry.path().generic_string());
+        if(entry.is_directory(ec)) {
+            // symlinked dirs are not followed; they may lead outside or back up the tree
+            if(entry.is_symlink(ec))
+                continue;
+            foundDirs.emplace_back(entryPath, name, true);
+            subdirs << entryPath;
+        } else if(filter.matches(name)) {
+            if(needsStat) {
+                auto size = entry.file_size(ec);
+                if(ec)
+                    continue;
+                foundFiles.emplace_back(entryPath, name, size, entry.last_write_time(ec), false);
+            } else {
+                foundFiles.emplace_back(entryPath, name, false);
+            }
+            foundFiles.back().sortKey = collators[worker].sortKey(entryPath);
+        }
+    }
+    std::lock_guard<std::mutex> lock(batchMutex);
+    std::move(foundFiles.begin(), foundFiles.end(), std::back_inserter(files));
+    std::move(foundDirs.begin(), foundDirs.end(), std::back_inserter(dirs));
+    if(worker == 0)
+        flush(false);
+    return true;
+}
+
+#ifdef __linux__
+// Returns false if the directory could not be opened so the caller can
+// fall back to std::filesystem (and get the same error reporting).
+bool DirectoryLoader::loadDirectoryLinux() {
+    QByteArray dirPath = path.toUtf8();
+    int fd = open(dirPath.constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(fd == -1)
+        return false;
+    if(!dirPath.endsWith('/'))
+        dirPath.append('/');
+    QString pathPrefix = QString::fromUtf8(dirPath);
+
+    std::vector<char> buffer(DENTS_BUFFER_SIZE);
+    for(;;) {
+        long nread = syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        if(nread == -1) {
+            qDebug() << "[DirectoryLoader] getdents64:" << strerror(errno);
+            break;
+        }
+        if(nread == 0)
+            break;
+        for(long pos = 0; pos < nread;) {
+            auto dent = reinterpret_cast<linux_dirent64 *>(buffer.data() + pos);
+            pos += dent->d_reclen;
+            const char *name = dent->d_name;
+            if(name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                continue;
+            // ignore hidden files
+            if(!showHidden && name[0] == '.')
+                continue;
+            size_t nameLength = strlen(name);
+            unsigned char type = dent->d_type;
+            // symlinks & filesystems without d_type
+            if(type == DT_LNK || type == DT_UNKNOWN) {
+                struct stat st;
+                if(fstatat(fd, name, &st, 0) != 0)
+                    continue;
+                type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN);
+            }
+            if(type == DT_DIR) {
+                QString entryName = QString::fromUtf8(name, static_cast<int>(nameLength));
+                setSortKey(dirs.emplace_back(pathPrefix + entryName, entryName, true));
+            } else if(type == DT_REG && filter.matches(name, nameLength)) {
+                QString entryName = QString::fromUtf8(name, static_cast<int>(nameLength));
+                if(!needsStat) {
+                    setSortKey(files.emplace_back(pathPrefix + entryName, entryName, false));
+                } else {
+#ifdef STATX_BASIC_STATS
+                    struct statx stx;
+                    if(statx(fd, name, 0, STATX_SIZE | STATX_MTIME, &stx) != 0)
+                        continue;
+                    setSortKey(files.emplace_back(pathPrefix + entryName, entryName, stx.stx_size,
+                                                  toFileTime(stx.stx_mtime.tv_sec, stx.stx_mtime.tv_nsec), false));
+#else
+                    struct stat st;
+                    if(fstatat(fd, name, &st, 0) != 0)
+                        continue;
+                    setSortKey(files.emplace_back(pathPrefix + entryName, entryName, st.st_size,
+                                                  toFileTime(st.st_mtim.tv_sec, st.st_mtim.tv_nsec), false));
+#endif
+                }
+            } else {
+                continue;
+            }
+            flush(false);
+            if(isCancelled()) {
+                close(fd);
+                return true;
+            }
+        }
+    }
+    close(fd);
+    return true;
+}
+#endif
+
+void DirectoryLoader::loadSnapshot() {
+    std::vector<FSEntry> snapshotFiles, snapshotDirs;
+    if(!DirectorySnapshot::read(snapshotFile, path, snapshotSignature, snapshotFiles, snapshotDirs))
+        return;
+    if(isCancelled())
+        return;
+    emit snapshotReady(std::move(snapshotFiles), std::move(snapshotDirs), id);
+    reconciling = true;
+}
+
+FSEntry &DirectoryLoader::setSortKey(FSEntry &entry) {
+    entry.sortKey = collator.sortKey(entry.path);
+    return entry;
+}
+
+void DirectoryLoader::flush(bool force) {
+    size_t count = files.size() + dirs.size();
+    // when reconciling the receiver needs the full listing, even an empty one
+    if(reconciling) {
+        if(!force)
+            return;
+    } else if(!count) {
+        return;
+    }
+    if(!force && count < batchSize && batchTimer.elapsed() < BATCH_INTERVAL)
+        return;
+    emit entriesReady(std::move(files), std::move(dirs), id);
+    files.clear();
+    dirs.clear();
+    batchSize = qMin(batchSize * 2, MAX_BATCH_SIZE);
+    batchTimer.restart();
+}
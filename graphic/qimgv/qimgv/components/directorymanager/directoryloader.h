@@ -0,0 +1,97 @@
+#pragma once
+
+/* Enumerates a directory and hands the entries over in batches.
+ *
+ * Used as a pool task by DirectoryManager so that large (or slow)
+ * directories do not block the gui thread. The first batch is kept small
+ * so the views can show something right away; later ones grow up to
+ * MAX_BATCH_SIZE. A batch is also flushed when BATCH_INTERVAL ms have
+ * passed since the previous one, which keeps slow mounts responsive.
+ *
+ * Entries come unsorted, sorting is left to the receiver. Path collation
+ * keys are computed here though, so the receiver never has to call
+ * QCollator::compare() while sorting.
+ * run() can also be called directly for a blocking load.
+ *
+ * With setSnapshot() a stored listing is sent first (snapshotReady) if it
+ * is still valid. The directory is then listed anyway, but the result
+ * goes out as a single batch so the receiver can diff it against the
+ * snapshot.
+ *
+ * Recursive listing walks the tree from several threads (see TreeWalker).
+ * Files come without the directories; the subdirectories it went through are
+ * reported in the dirs list instead so the receiver can watch them.
+ *
+ * On linux non-recursive listing reads getdents64 records directly:
+ * file type comes from d_type, names are checked against the extension
+ * filter before anything is allocated, and size / mtime are only fetched
+ * (via statx) when the receiver says it needs them for sorting.
+ */
+
+#include <QObject>
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QCollator>
+#include <QDebug>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <filesystem>
+#include "sourcecontainers/fsentry.h"
+#include "utils/stuff.h"
+#include "utils/extensionfilter.h"
+#include "treewalker.h"
+#include "directorysnapshot.h"
+
+#ifdef Q_OS_WIN32
+#include "windows.h"
+#endif
+
+class DirectoryLoader : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    DirectoryLoader(QString _path, bool _recursive, ExtensionFilter _filter, bool _showHidden, bool _needsStat, std::shared_ptr<std::atomic<bool>> _cancelled, quint64 _id);
+    void run() override;
+    void setSnapshot(QString _snapshotFile, QByteArray _snapshotSignature);
+
+signals:
+    void snapshotReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id);
+    void entriesReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id);
+    void finished(quint64 id);
+
+private:
+    void loadDirectory();
+    void loadDirectoryRecursive();
+    void loadSnapshot();
+    bool visitDirectory(int worker, const QString &dirPath, QStringList &subdirs);
+#ifdef __linux__
+    bool loadDirectoryLinux();
+#endif
+    bool isHidden(const std::filesystem::directory_entry &entry, const QString &name) const;
+    void flush(bool force);
+    FSEntry &setSortKey(FSEntry &entry);
+    bool isCancelled() const;
+
+    QString path;
+    bool recursive, showHidden, needsStat;
+    ExtensionFilter filter;
+    QCollator collator;
+    // one per walker thread, QCollator is not thread safe
+    std::vector<QCollator> collators;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+    quint64 id;
+    QString snapshotFile;
+    QByteArray snapshotSignature;
+    bool reconciling;
+
+    std::vector<FSEntry> files, dirs;
+    std::mutex batchMutex;
+    QElapsedTimer batchTimer;
+    size_t batchSize;
+
+    const size_t FIRST_BATCH_SIZE = 64;
+    const size_t MAX_BATCH_SIZE = 4096;
+    const int BATCH_INTERVAL = 50;
+    const size_t DENTS_BUFFER_SIZE = 256 * 1024;
+};
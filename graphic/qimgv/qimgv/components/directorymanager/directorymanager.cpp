@@ -3,28 +3,78 @@
 namespace fs = std::filesystem;
 
 DirectoryManager::DirectoryManager() :
+    fileIndex(fileEntryVec),
+    dirIndex(dirEntryVec),
+    loadId(0),
+    mAsyncLoading(false),
+    mLoading(false),
+    mLoaderStats(true),
+    mEntriesHaveStats(true),
+    mReconciling(false),
+    mSnapshotUnchanged(false),
     watcher(nullptr),
+    nativeWatcher(nullptr),
+    pollingWatcher(nullptr),
     mSortingMode(SORT_NAME)
 {
-    regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    pool = new QThreadPool(this);
     collator.setNumericMode(true);
+    changeTimer.setSingleShot(true);
+    changeTimer.setInterval(CHANGE_BATCH_INTERVAL);
+    connect(&changeTimer, &QTimer::timeout, this, &DirectoryManager::applyChanges);
 
     readSettings();
     setSortingMode(settings->sortingMode());
     connect(settings, &Settings::settingsChanged, this, &DirectoryManager::readSettings);
 }
 
+DirectoryManager::~DirectoryManager() {
+    cancelLoading();
+    pool->waitForDone();
+}
+
 template< typename T, typename Pred >
 typename std::vector<T>::iterator
 insert_sorted(std::vector<T> & vec, T const& item, Pred pred) {
     return vec.insert(std::upper_bound(vec.begin(), vec.end(), item, pred), item);
 }
 
+// merges an unsorted batch into a sorted vector
+// returns the positions the new items ended up at (ascending)
+template< typename T, typename Pred >
+QList<int> merge_sorted(std::vector<T> & vec, std::vector<T> & batch, Pred pred) {
+    QList<int> indices;
+    if(batch.empty())
+        return indices;
+    std::sort(batch.begin(), batch.end(), pred);
+    std::vector<T> merged;
+    merged.reserve(vec.size() + batch.size());
+    indices.reserve(static_cast<int>(batch.size()));
+    auto a = vec.begin();
+    auto b = batch.begin();
+    while(a != vec.end() || b != batch.end()) {
+        // existing items go first on ties
+        if(b == batch.end() || (a != vec.end() && !pred(*b, *a))) {
+            merged.push_back(std::move(*a++));
+        } else {
+            indices << static_cast<int>(merged.size());
+            merged.push_back(std::move(*b++));
+        }
+    }
+    vec.swap(merged);
+    return indices;
+}
+
+// all entries normally carry a precomputed key; collator is a fallback
 bool DirectoryManager::path_entry_compare(const FSEntry &e1, const FSEntry &e2) const {
+    if(e1.sortKey && e2.sortKey)
+        return e1.sortKey->compare(*e2.sortKey) < 0;
     return collator.compare(e1.path, e2.path) < 0;
 };
 
 bool DirectoryManager::path_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const {
+    if(e1.sortKey && e2.sortKey)
+        return e1.sortKey->compare(*e2.sortKey) > 0;
     return collator.compare(e1.path, e2.path) > 0;
 };
 
@@ -67,11 +117,30 @@ CompareFunction DirectoryManager::compareFunction() {
     return cmpFn;
 }
 
+CompareFunction DirectoryManager::dirCompareFunction() {
+    if(settings->sortFolders())
+        return compareFunction();
+    return &DirectoryManager::path_entry_compare;
+}
+
 void DirectoryManager::startFileWatcher(QString directoryPath) {
     if(directoryPath == "")
         return;
-    if(!watcher)
-        watcher = DirectoryWatcher::newInstance();
+    DirectoryWatcher *instance;
+    if(DirectoryWatcher::isRemotePath(directoryPath)) {
+        if(!pollingWatcher)
+            pollingWatcher = DirectoryWatcher::newPollingInstance();
+        instance = pollingWatcher;
+    } else {
+        if(!nativeWatcher)
+            nativeWatcher = DirectoryWatcher::newInstance();
+        instance = nativeWatcher;
+    }
+    if(watcher != instance) {
+        stopFileWatcher();
+        watcher = instance;
+    }
+    watcher->setRecursive(mListSource == SOURCE_DIRECTORY_RECURSIVE);
 
     connect(watcher, &DirectoryWatcher::fileCreated,  this, &DirectoryManager::onFileAddedExternal,    Qt::UniqueConnection);
     connect(watcher, &DirectoryWatcher::fileDeleted,  this, &DirectoryManager::onFileRemovedExternal,  Qt::UniqueConnection);
@@ -79,6 +148,9 @@ void DirectoryManager::startFileWatcher(QString directoryPath) {
     connect(watcher, &DirectoryWatcher::fileRenamed,  this, &DirectoryManager::onFileRenamedExternal,  Qt::UniqueConnection);
 
     watcher->setWatchPath(directoryPath);
+    if(watcher->isRecursive())
+        watcher->addSubdirectories(loadedSubdirs);
+    loadedSubdirs.clear();
     watcher->observe();
 }
 
@@ -87,6 +159,8 @@ void DirectoryManager::stopFileWatcher() {
         return;
 
     watcher->stopObserving();
+    changeTimer.stop();
+    pendingChanges.clear();
 
     disconnect(watcher, &DirectoryWatcher::fileCreated,  this, &DirectoryManager::onFileAddedExternal);
     disconnect(watcher, &DirectoryWatcher::fileDeleted,  this, &DirectoryManager::onFileRemovedExternal);
@@ -99,7 +173,7 @@ void DirectoryManager::stopFileWatcher() {
 // ##############################################################
 
 void DirectoryManager::readSettings() {
-    regex.setPattern(settings->supportedFormatsRegex());
+    filter.setExtensions(settings->supportedFormats());
 }
 
 bool DirectoryManager::setDirectory(QString dirPath) {
@@ -121,11 +195,7 @@ bool DirectoryManager::setDirectory(QString dirPath) {
     }
     mListSource = SOURCE_DIRECTORY;
     mDirectoryPath = dirPath;
-
     loadEntryList(dirPath, false);
-    sortEntryLists();
-    emit loaded(dirPath);
-    startFileWatcher(dirPath);
     return true;
 }
 
@@ -141,12 +211,9 @@ bool DirectoryManager::setDirectoryRecursive(QString dirPath) {
         qDebug() << "[DirectoryManager] Error - path is not a directory.";
         return false;
     }
-    stopFileWatcher();
     mListSource = SOURCE_DIRECTORY_RECURSIVE;
     mDirectoryPath = dirPath;
     loadEntryList(dirPath, true);
-    sortEntryLists();
-    emit loaded(dirPath);
     return true;
 }
 
@@ -158,21 +225,11 @@ QString DirectoryManager::directoryPath() const {
 }
 
 int DirectoryManager::indexOfFile(QString filePath) const {
-    auto item = find_if(fileEntryVec.begin(), fileEntryVec.end(), [filePath](const FSEntry& e) {
-        return e.path == filePath;
-    });
-    if(item != fileEntryVec.end())
-        return distance(fileEntryVec.begin(), item);
-    return -1;
+    return fileIndex.indexOf(filePath);
 }
 
 int DirectoryManager::indexOfDir(QString dirPath) const {
-    auto item = find_if(dirEntryVec.begin(), dirEntryVec.end(), [dirPath](const FSEntry& e) {
-        return e.path == dirPath;
-    });
-    if(item != dirEntryVec.end())
-        return distance(dirEntryVec.begin(), item);
-    return -1;
+    return dirIndex.indexOf(dirPath);
 }
 
 QString DirectoryManager::filePathAt(int index) const {
@@ -274,7 +331,7 @@ QDateTime DirectoryManager::lastModified(QString filePath) const {
 // TODO: what about symlinks?
 inline
 bool DirectoryManager::isSupportedFile(QString path) const {
-    return ( isFile(path) && regex.match(path).hasMatch() );
+    return ( filter.matches(path) && isFile(path) );
 }
 
 bool DirectoryManager::isFile(QString path) const {
@@ -298,110 +355,311 @@ bool DirectoryManager::isEmpty() const {
 }
 
 bool DirectoryManager::containsFile(QString filePath) const {
-    return (std::find(fileEntryVec.begin(), fileEntryVec.end(), filePath) != fileEntryVec.end());
+    return fileIndex.contains(filePath);
 }
 
 bool DirectoryManager::containsDir(QString dirPath) const {
-    return (std::find(dirEntryVec.begin(), dirEntryVec.end(), dirPath) != dirEntryVec.end());
+    return dirIndex.contains(dirPath);
 }
 
 // ##############################################################
 // ###################### PRIVATE METHODS #######################
 // ##############################################################
 void DirectoryManager::loadEntryList(QString directoryPath, bool recursive) {
+    cancelLoading();
+    stopFileWatcher();
     dirEntryVec.clear();
     fileEntryVec.clear();
-    if(recursive) { // load files only
-        addEntriesFromDirectoryRecursive(fileEntryVec, directoryPath);
-    } else { // load dirs & files
-        addEntriesFromDirectory(fileEntryVec, directoryPath);
+    dirIndex.clear();
+    fileIndex.clear();
+    loadingOverrides.clear();
+    loadedSubdirs.clear();
+    mLoading = true;
+    emit loadStarted(directoryPath);
+
+    mLoaderStats = sortNeedsStats(mSortingMode);
+    mEntriesHaveStats = mLoaderStats;
+    loadCancelled = std::make_shared<std::atomic<bool>>(false);
+    auto loader = new DirectoryLoader(directoryPath, recursive, filter, settings->showHiddenFiles(),
+                                      mLoaderStats, loadCancelled, ++loadId);
+    mReconciling = false;
+    mSnapshotUnchanged = false;
+    if(mAsyncLoading) {
+        if(!recursive) {
+            snapshotStamp = DirectorySnapshot::stamp(directoryPath);
+            loader->setSnapshot(DirectorySnapshot::filePath(snapshotDir(), directoryPath), snapshotSignature());
+            connect(loader, &DirectoryLoader::snapshotReady, this, &DirectoryManager::onSnapshotReady, Qt::QueuedConnection);
+        }
+        connect(loader, &DirectoryLoader::entriesReady, this, &DirectoryManager::onEntriesReady, Qt::QueuedConnection);
+        connect(loader, &DirectoryLoader::finished, this, &DirectoryManager::onLoaderFinished, Qt::QueuedConnection);
+        loader->setAutoDelete(true);
+        pool->start(loader);
+    } else {
+        connect(loader, &DirectoryLoader::entriesReady, this, &DirectoryManager::onEntriesReady, Qt::DirectConnection);
+        connect(loader, &DirectoryLoader::finished, this, &DirectoryManager::onLoaderFinished, Qt::DirectConnection);
+        loader->run();
+        delete loader;
     }
 }
 
-// both directories & files
-void DirectoryManager::addEntriesFromDirectory(std::vector<FSEntry> &entryVec, QString directoryPath) {
-    QRegularExpressionMatch match;
-    for(const auto & entry : fs::directory_iterator(toStdString(directoryPath))) {
-        QString name = QString::fromStdString(entry.path().filename().generic_string());
-#ifndef Q_OS_WIN32
-        // ignore hidden files
-        if(!settings->showHiddenFiles() && name.startsWith("."))
-            continue;
-#else
-        DWORD attributes = GetFileAttributes(entry.path().generic_string().c_str());
-        if(!settings->showHiddenFiles() && attributes & FILE_ATTRIBUTE_HIDDEN)
+void DirectoryManager::cancelLoading() {
+    if(loadCancelled)
+        loadCancelled->store(true);
+    mLoading = false;
+}
+
+// keeps the entries we touched from being overwritten by a late batch
+void DirectoryManager::overrideLoading(const QString &path) {
+    if(mLoading)
+        loadingOverrides.insert(path);
+}
+
+void DirectoryManager::dropOverridden(std::vector<FSEntry> &files, std::vector<FSEntry> &dirs) const {
+    if(loadingOverrides.isEmpty())
+        return;
+    auto overridden = [this](const FSEntry &e) {
+        return loadingOverrides.contains(e.path);
+    };
+    files.erase(std::remove_if(files.begin(), files.end(), overridden), files.end());
+    dirs.erase(std::remove_if(dirs.begin(), dirs.end(), overridden), dirs.end());
+}
+
+// Stored listing; comes before anything else the loader sends.
+// It is already sorted for the current mode (see snapshotSignature()).
+void DirectoryManager::onSnapshotReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id) {
+    if(id != loadId)
+        return;
+    dropOverridden(files, dirs);
+    mReconciling = true;
+    auto dirIndices = adoptSnapshot(dirEntryVec, dirIndex, dirs, dirCompareFunction());
+    auto fileIndices = adoptSnapshot(fileEntryVec, fileIndex, files, compareFunction());
+    if(dirIndices.count() || fileIndices.count())
+        emit entriesInserted(dirIndices, fileIndices);
+}
+
+// Replaces vec with the (already sorted) snapshot and puts back whatever
+// was inserted by hand before it arrived, usually just the file being opened.
+// Returns the positions of the snapshot entries.
+QList<int> DirectoryManager::adoptSnapshot(std::vector<FSEntry> &vec, EntryIndex &index, std::vector<FSEntry> &snapshot, CompareFunction cmpFn) {
+    std::vector<FSEntry> existing;
+    existing.swap(vec);
+    vec.swap(snapshot);
+    QSet<QString> existingPaths;
+    for(auto &entry : existing) {
+        existingPaths.insert(entry.path);
+        insert_sorted(vec, entry, std::bind(cmpFn, this, std::placeholders::_1, std::placeholders::_2));
+    }
+    index.invalidateFrom(0);
+    QList<int> indices;
+    indices.reserve(static_cast<int>(vec.size()));
+    for(int i = 0; i < static_cast<int>(vec.size()); i++) {
+        if(existingPaths.isEmpty() || !existingPaths.contains(vec[i].path))
+            indices << i;
+    }
+    return indices;
+}
+
+// Full rescan after a snapshot; only what differs gets applied.
+void DirectoryManager::reconcile(std::vector<FSEntry> &files, std::vector<FSEntry> &dirs) {
+    mReconciling = false;
+    QStringList removedFiles, removedDirs, modifiedFiles;
+    std::vector<FSEntry> newFiles, newDirs;
+    diffEntries(fileEntryVec, fileIndex, files, removedFiles, newFiles, &modifiedFiles);
+    diffEntries(dirEntryVec, dirIndex, dirs, removedDirs, newDirs, nullptr);
+    mSnapshotUnchanged = removedFiles.isEmpty() && removedDirs.isEmpty() && modifiedFiles.isEmpty() &&
+                         newFiles.empty() && newDirs.empty();
+    applyDiff(removedDirs, removedFiles, newDirs, newFiles, modifiedFiles);
+    // changed stats may have moved some files around
+    if(modifiedFiles.count() && sortNeedsStats(mSortingMode))
+        sortEntryLists();
+}
+
+// Compares a fresh listing with the current one. Entries found in both
+// take over the fresh collation key (snapshots don't have them) and stats.
+void DirectoryManager::diffEntries(std::vector<FSEntry> &current, const EntryIndex &index, std::vector<FSEntry> &fresh,
+                                   QStringList &removed, std::vector<FSEntry> &added, QStringList *modified) const
+{
+    QSet<QString> freshPaths;
+    freshPaths.reserve(static_cast<int>(fresh.size()));
+    for(auto &entry : fresh) {
+        freshPaths.insert(entry.path);
+        int i = index.indexOf(entry.path);
+        if(i == -1) {
+            added.push_back(std::move(entry));
             continue;
-#endif
-        QString path = QString::fromStdString(entry.path().generic_string());
-        match = regex.match(name);
-        if(entry.is_directory()) { // this can still throw std::bad_alloc ..
-            FSEntry newEntry;
-            try {
-                newEntry.name = name;
-                newEntry.path = path;
-                newEntry.isDirectory = true;
-                //newEntry.size = entry.file_size();
-                //newEntry.modifyTime = entry.last_write_time();
-            } catch (const std::filesystem::filesystem_error &err) {
-                qDebug() << "[DirectoryManager]" << err.what();
-                continue;
-            }
-            dirEntryVec.emplace_back(newEntry);
-        } else if (match.hasMatch()) {
-            FSEntry newEntry;
-            try {
-                newEntry.name = name;
-                newEntry.path = path;
-                newEntry.isDirectory = false;
-                newEntry.size = entry.file_size();
-                newEntry.modifyTime = entry.last_write_time();
-            } catch (const std::filesystem::filesystem_error &err) {
-                qDebug() << "[DirectoryManager]" << err.what();
-                continue;
-            }
-            entryVec.emplace_back(newEntry);
+        }
+        FSEntry &existing = current[i];
+        existing.sortKey = std::move(entry.sortKey);
+        if(modified && mLoaderStats && (existing.size != entry.size || existing.modifyTime != entry.modifyTime)) {
+            existing.size = entry.size;
+            existing.modifyTime = entry.modifyTime;
+            *modified << entry.path;
         }
     }
+    for(auto &entry : current) {
+        if(!freshPaths.contains(entry.path))
+            removed << entry.path;
+    }
 }
 
-void DirectoryManager::addEntriesFromDirectoryRecursive(std::vector<FSEntry> &entryVec, QString directoryPath) {
-    QRegularExpressionMatch match;
-    for(const auto & entry : fs::recursive_directory_iterator(toStdString(directoryPath))) {
-        QString name = QString::fromStdString(entry.path().filename().generic_string());
-        QString path = QString::fromStdString(entry.path().generic_string());
-        match = regex.match(name);
-        if(!entry.is_directory() && match.hasMatch()) {
-            FSEntry newEntry;
-            try {
-                newEntry.name = name;
-                newEntry.path = path;
-                newEntry.isDirectory = false;
-                newEntry.size = entry.file_size();
-                newEntry.modifyTime = entry.last_write_time();
-            } catch (const std::filesystem::filesystem_error &err) {
-                qDebug() << "[DirectoryManager]" << err.what();
-                continue;
-            }
-            entryVec.emplace_back(newEntry);
+void DirectoryManager::onEntriesReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id) {
+    if(id != loadId)
+        return;
+    dropOverridden(files, dirs);
+    // recursive listing only lists files, dirs are there for the watcher
+    if(mListSource == SOURCE_DIRECTORY_RECURSIVE) {
+        for(auto &dir : dirs)
+            loadedSubdirs << dir.path;
+        dirs.clear();
+    }
+    // sorting mode was changed while loading
+    if(mEntriesHaveStats && !mLoaderStats)
+        loadEntryStats(files);
+    if(mReconciling) {
+        reconcile(files, dirs);
+        return;
+    }
+    auto dirIndices = merge_sorted(dirEntryVec, dirs, std::bind(dirCompareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    auto fileIndices = merge_sorted(fileEntryVec, files, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    if(dirIndices.count())
+        dirIndex.invalidateFrom(dirIndices.first());
+    if(fileIndices.count())
+        fileIndex.invalidateFrom(fileIndices.first());
+    if(dirIndices.count() || fileIndices.count())
+        emit entriesInserted(dirIndices, fileIndices);
+}
+
+void DirectoryManager::onLoaderFinished(quint64 id) {
+    if(id != loadId)
+        return;
+    mLoading = false;
+    loadingOverrides.clear();
+    mReconciling = false;
+    emit loaded(mDirectoryPath);
+    if(mListSource == SOURCE_DIRECTORY || mListSource == SOURCE_DIRECTORY_RECURSIVE)
+        startFileWatcher(mDirectoryPath);
+    saveSnapshot();
+}
+
+// Anything that changes the order or the set of listed entries
+// must be in here, see DirectorySnapshot.
+QByteArray DirectoryManager::snapshotSignature() const {
+    QByteArray signature = settings->supportedFormats().join(',');
+    signature += "|hidden:" + QByteArray::number(settings->showHiddenFiles());
+    signature += "|sortFolders:" + QByteArray::number(settings->sortFolders());
+    signature += "|sort:" + QByteArray::number(static_cast<int>(mSortingMode));
+    signature += "|locale:" + collator.locale().name().toUtf8();
+    return signature;
+}
+
+QString DirectoryManager::snapshotDir() const {
+    return settings->tmpDir() + "snapshots/";
+}
+
+// keep big listings around for the next time the directory is opened
+void DirectoryManager::saveSnapshot() {
+    if(!mAsyncLoading || mListSource != SOURCE_DIRECTORY || mSnapshotUnchanged)
+        return;
+    if(totalCount() < DirectorySnapshot::MIN_ENTRIES)
+        return;
+    pool->start(new DirectorySnapshotWriter(DirectorySnapshot::filePath(snapshotDir(), mDirectoryPath), mDirectoryPath,
+                                            snapshotSignature(), snapshotStamp, fileEntryVec, dirEntryVec));
+}
+
+void DirectoryManager::setAsyncLoading(bool mode) {
+    mAsyncLoading = mode;
+}
+
+bool DirectoryManager::isLoading() const {
+    return mLoading;
+}
+
+bool DirectoryManager::sortNeedsStats(SortingMode mode) const {
+    return mode == SORT_TIME || mode == SORT_TIME_DESC || mode == SORT_SIZE || mode == SORT_SIZE_DESC;
+}
+
+void DirectoryManager::setSortKey(FSEntry &entry) const {
+    entry.sortKey = collator.sortKey(entry.path);
+}
+
+void DirectoryManager::loadEntryStats(std::vector<FSEntry> &entries) {
+    std::error_code ec;
+    for(auto &entry : entries) {
+        std::filesystem::directory_entry stdEntry(toStdString(entry.path), ec);
+        if(ec)
+            continue;
+        entry.size = stdEntry.file_size(ec);
+        entry.modifyTime = stdEntry.last_write_time(ec);
+    }
+}
+
+// Erases the entries for paths in one pass over the vector.
+// Returns their former positions in ascending order.
+QList<int> DirectoryManager::eraseEntries(std::vector<FSEntry> &vec, EntryIndex &index, const QStringList &paths, QStringList *erasedPaths) {
+    QList<int> indices;
+    for(auto &path : paths) {
+        int i = index.indexOf(path);
+        if(i != -1)
+            indices << i;
+    }
+    if(indices.isEmpty())
+        return indices;
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    for(auto i : indices) {
+        if(erasedPaths)
+            *erasedPaths << vec[i].path;
+        index.remove(vec[i].path, i);
+    }
+    auto out = vec.begin() + indices.first();
+    int next = 0;
+    for(auto it = out; it != vec.end(); ++it) {
+        if(next < indices.count() && indices[next] == it - vec.begin()) {
+            next++;
+            continue;
         }
+        if(out != it)
+            *out = std::move(*it);
+        ++out;
     }
+    vec.erase(out, vec.end());
+    return indices;
 }
 
 void DirectoryManager::sortEntryLists() {
-    if(settings->sortFolders())
-        std::sort(dirEntryVec.begin(), dirEntryVec.end(), std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
-    else
-        std::sort(dirEntryVec.begin(), dirEntryVec.end(), std::bind(&DirectoryManager::path_entry_compare, this, std::placeholders::_1, std::placeholders::_2));
-    std::sort(fileEntryVec.begin(), fileEntryVec.end(), std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    QList<int> dirOrder = sortEntries(dirEntryVec, dirIndex, dirCompareFunction());
+    QList<int> fileOrder = sortEntries(fileEntryVec, fileIndex, compareFunction());
+    emit sortingChanged(dirOrder, fileOrder);
+}
+
+// Returns where each entry came from: order[newIndex] == oldIndex.
+// Stable, so entries that compare equal don't move around.
+QList<int> DirectoryManager::sortEntries(std::vector<FSEntry> &vec, EntryIndex &index, CompareFunction cmpFn) {
+    QList<int> order;
+    order.reserve(static_cast<int>(vec.size()));
+    for(int i = 0; i < static_cast<int>(vec.size()); i++)
+        order << i;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return (this->*cmpFn)(vec[a], vec[b]);
+    });
+    std::vector<FSEntry> sorted;
+    sorted.reserve(vec.size());
+    for(auto i : order)
+        sorted.push_back(std::move(vec[i]));
+    vec.swap(sorted);
+    index.invalidateFrom(0);
+    return order;
 }
 
 void DirectoryManager::setSortingMode(SortingMode mode) {
     if(mode != mSortingMode) {
         mSortingMode = mode;
-        if(fileEntryVec.size() > 1 || dirEntryVec.size() > 1) {
-            sortEntryLists();
-            emit sortingChanged();
+        if(sortNeedsStats(mode) && !mEntriesHaveStats) {
+            loadEntryStats(fileEntryVec);
+            mEntriesHaveStats = true;
         }
+        if(fileEntryVec.size() > 1 || dirEntryVec.size() > 1)
+            sortEntryLists();
     }
 }
 
@@ -417,14 +675,17 @@ bool DirectoryManager::insertFileEntry(const QString &filePath) {
     return forceInsertFileEntry(filePath);
 }
 
-// skips filename regex check
+// skips file extension check
 bool DirectoryManager::forceInsertFileEntry(const QString &filePath) {
+    overrideLoading(filePath);
     if(!this->isFile(filePath) || containsFile(filePath))
         return false;
     std::filesystem::directory_entry stdEntry(toStdString(filePath));
     QString fileName = QString::fromStdString(stdEntry.path().filename().generic_string()); // isn't it beautiful
     FSEntry FSEntry(filePath, fileName, stdEntry.file_size(), stdEntry.last_write_time(), stdEntry.is_directory());
-    insert_sorted(fileEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    setSortKey(FSEntry);
+    auto it = insert_sorted(fileEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    fileIndex.invalidateFrom(it - fileEntryVec.begin());
     if(!directoryPath().isEmpty()) {
         qDebug() << "fileIns" << filePath << directoryPath();
         emit fileAdded(filePath);
@@ -433,10 +694,12 @@ bool DirectoryManager::forceInsertFileEntry(const QString &filePath) {
 }
 
 void DirectoryManager::removeFileEntry(const QString &filePath) {
+    overrideLoading(filePath);
     if(!containsFile(filePath))
         return;
     int index = indexOfFile(filePath);
     fileEntryVec.erase(fileEntryVec.begin() + index);
+    fileIndex.remove(filePath, index);
     qDebug() << "fileRem" << filePath;
     emit fileRemoved(filePath, index);
 }
@@ -446,8 +709,10 @@ void DirectoryManager::updateFileEntry(const QString &filePath) {
         return;
     FSEntry newEntry(filePath);
     int index = indexOfFile(filePath);
-    if(fileEntryVec.at(index).modifyTime != newEntry.modifyTime)
+    if(fileEntryVec.at(index).modifyTime != newEntry.modifyTime) {
+        newEntry.sortKey = fileEntryVec.at(index).sortKey;
         fileEntryVec.at(index) = newEntry;
+    }
     qDebug() << "fileMod" << filePath;
     emit fileModified(filePath);
 }
@@ -455,6 +720,8 @@ void DirectoryManager::updateFileEntry(const QString &filePath) {
 void DirectoryManager::renameFileEntry(const QString &oldFilePath, const QString &newFileName) {
     QFileInfo fi(oldFilePath);
     QString newFilePath = fi.absolutePath() + "/" + newFileName;
+    overrideLoading(oldFilePath);
+    overrideLoading(newFilePath);
     if(!containsFile(oldFilePath)) {
         if(containsFile(newFilePath))
             updateFileEntry(newFilePath);
@@ -469,15 +736,19 @@ void DirectoryManager::renameFileEntry(const QString &oldFilePath, const QString
     if(containsFile(newFilePath)) {
         int replaceIndex = indexOfFile(newFilePath);
         fileEntryVec.erase(fileEntryVec.begin() + replaceIndex);
+        fileIndex.remove(newFilePath, replaceIndex);
         emit fileRemoved(newFilePath, replaceIndex);
     }
     // remove the old one
     int oldIndex = indexOfFile(oldFilePath);
     fileEntryVec.erase(fileEntryVec.begin() + oldIndex);
+    fileIndex.remove(oldFilePath, oldIndex);
     // insert
     std::filesystem::directory_entry stdEntry(toStdString(newFilePath));
     FSEntry FSEntry(newFilePath, newFileName, stdEntry.file_size(), stdEntry.last_write_time(), stdEntry.is_directory());
-    insert_sorted(fileEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    setSortKey(FSEntry);
+    auto it = insert_sorted(fileEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    fileIndex.invalidateFrom(it - fileEntryVec.begin());
     qDebug() << "fileRen" << oldFilePath << newFilePath;
     emit fileRenamed(oldFilePath, oldIndex, newFilePath, indexOfFile(newFilePath));
 }
@@ -485,6 +756,7 @@ void DirectoryManager::renameFileEntry(const QString &oldFilePath, const QString
 // ---- dir entries
 
 bool DirectoryManager::insertDirEntry(const QString &dirPath) {
+    overrideLoading(dirPath);
     if(containsDir(dirPath))
         return false;
     std::filesystem::directory_entry stdEntry(toStdString(dirPath));
@@ -493,36 +765,45 @@ bool DirectoryManager::insertDirEntry(const QString &dirPath) {
     FSEntry.name = dirName;
     FSEntry.path = dirPath;
     FSEntry.isDirectory = true;
-    insert_sorted(dirEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    setSortKey(FSEntry);
+    auto it = insert_sorted(dirEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    dirIndex.invalidateFrom(it - dirEntryVec.begin());
     qDebug() << "dirIns" << dirPath;
     emit dirAdded(dirPath);
     return true;
 }
 
 void DirectoryManager::removeDirEntry(const QString &dirPath) {
+    overrideLoading(dirPath);
     if(!containsDir(dirPath))
         return;
     int index = indexOfDir(dirPath);
     dirEntryVec.erase(dirEntryVec.begin() + index);
+    dirIndex.remove(dirPath, index);
     qDebug() << "dirRem" << dirPath;
     emit dirRemoved(dirPath, index);
 }
 
 void DirectoryManager::renameDirEntry(const QString &oldDirPath, const QString &newDirName) {
-    if(!containsDir(oldDirPath))
-        return;
     QFileInfo fi(oldDirPath);
     QString newDirPath = fi.absolutePath() + "/" + newDirName;
+    overrideLoading(oldDirPath);
+    overrideLoading(newDirPath);
+    if(!containsDir(oldDirPath))
+        return;
     // remove the old one
     int oldIndex = indexOfDir(oldDirPath);
     dirEntryVec.erase(dirEntryVec.begin() + oldIndex);
+    dirIndex.remove(oldDirPath, oldIndex);
     // insert
     std::filesystem::directory_entry stdEntry(toStdString(newDirPath));
     FSEntry FSEntry;
     FSEntry.name = newDirName;
     FSEntry.path = newDirPath;
     FSEntry.isDirectory = true;
-    insert_sorted(dirEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    setSortKey(FSEntry);
+    auto it = insert_sorted(dirEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    dirIndex.invalidateFrom(it - dirEntryVec.begin());
     qDebug() << "dirRen" << oldDirPath << newDirPath;
     emit dirRenamed(oldDirPath, oldIndex, newDirPath, indexOfDir(newDirPath));
 }
@@ -548,23 +829,36 @@ bool DirectoryManager::fileWatcherActive() {
 //----------------------------------------------------------------------------
 // fs watcher events  ( onFile___External() )
 // these take file NAMES, not paths
+//
+// Creates & deletes tend to come in bursts (copying or extracting a bunch of
+// files, deleting a selection), so they are only queued here and applied
+// together once the burst settles, see applyChanges().
 void DirectoryManager::onFileRemovedExternal(QString fileName) {
-    QString fullPath = watcher->watchPath() + "/" + fileName;
-    removeDirEntry(fullPath);
-    removeFileEntry(fullPath);
+    queueChange(watcher->watchPath() + "/" + fileName);
 }
 
 void DirectoryManager::onFileAddedExternal(QString fileName) {
-    QString fullPath = watcher->watchPath() + "/" + fileName;
-    if(isDir(fullPath))
-        insertDirEntry(fullPath);
-    else
-        insertFileEntry(fullPath);
+    queueChange(watcher->watchPath() + "/" + fileName);
 }
 
+// renames are applied right away so the views can keep selection on the
+// renamed item; anything queued before it goes first
 void DirectoryManager::onFileRenamedExternal(QString oldName, QString newName) {
+    applyChanges();
     QString oldPath = watcher->watchPath() + "/" + oldName;
     QString newPath = watcher->watchPath() + "/" + newName;
+    // recursive mode: names are relative paths. Moves between directories
+    // and directory renames are a removal + an insertion.
+    if(mListSource == SOURCE_DIRECTORY_RECURSIVE) {
+        QFileInfo newInfo(newPath);
+        if(isDir(newPath) || QFileInfo(oldPath).absolutePath() != newInfo.absolutePath()) {
+            queueChange(oldPath);
+            queueChange(newPath);
+        } else {
+            renameFileEntry(oldPath, newInfo.fileName());
+        }
+        return;
+    }
     if(isDir(newPath))
         renameDirEntry(oldPath, newName);
     else
@@ -572,5 +866,158 @@ void DirectoryManager::onFileRenamedExternal(QString oldName, QString newName) {
 }
 
 void DirectoryManager::onFileModifiedExternal(QString fileName) {
-    updateFileEntry(watcher->watchPath() + "/" + fileName);
+    QString fullPath = watcher->watchPath() + "/" + fileName;
+    // will be re-read when the batch is applied
+    if(pendingChanges.contains(fullPath))
+        return;
+    updateFileEntry(fullPath);
+}
+
+void DirectoryManager::queueChange(const QString &path) {
+    pendingChanges.insert(path);
+    // not restarted on purpose: a steady stream of events still gets
+    // applied every CHANGE_BATCH_INTERVAL ms
+    if(!changeTimer.isActive())
+        changeTimer.start();
+}
+
+// Every queued path is checked against what is on disk now, so a file
+// that was created and deleted within one window never shows up at all.
+void DirectoryManager::applyChanges() {
+    changeTimer.stop();
+    if(pendingChanges.isEmpty())
+        return;
+    bool recursive = (mListSource == SOURCE_DIRECTORY_RECURSIVE);
+    QStringList removedFiles, removedDirs, modifiedFiles;
+    QSet<QString> removedTrees;
+    std::vector<FSEntry> newFiles, newDirs;
+    for(auto &path : pendingChanges) {
+        if(recursive && isHiddenSubpath(path))
+            continue;
+        std::error_code ec;
+        std::filesystem::directory_entry stdEntry(toStdString(path), ec);
+        bool exists = !ec && stdEntry.exists(ec);
+        bool dir = exists && stdEntry.is_directory(ec);
+        bool file = exists && !dir && stdEntry.is_regular_file(ec) && filter.matches(path);
+        if(recursive && !file) {
+            // a whole directory came or went; only its files are listed
+            if(containsFile(path))
+                removedFiles << path;
+            if(dir)
+                loadSubtree(path);
+            else if(!exists)
+                removedTrees.insert(path);
+            continue;
+        }
+        if(!dir && containsDir(path))
+            removedDirs << path;
+        if(!file && containsFile(path))
+            removedFiles << path;
+        if(!dir && !file)
+            continue;
+        QString name = QString::fromStdString(stdEntry.path().filename().generic_string());
+        if(dir) {
+            if(containsDir(path))
+                continue;
+            FSEntry entry(path, name, true);
+            setSortKey(entry);
+            newDirs.push_back(std::move(entry));
+        } else if(containsFile(path)) {
+            modifiedFiles << path;
+        } else {
+            FSEntry entry(path, name, stdEntry.file_size(ec), stdEntry.last_write_time(ec), false);
+            setSortKey(entry);
+            newFiles.push_back(std::move(entry));
+        }
+    }
+    pendingChanges.clear();
+    if(!removedTrees.isEmpty())
+        collectRemovedFiles(removedTrees, removedFiles);
+    applyDiff(removedDirs, removedFiles, newDirs, newFiles, modifiedFiles);
+}
+
+// Removals go first, in one pass, then additions in one merge;
+// each followed by a single notification.
+void DirectoryManager::applyDiff(const QStringList &removedDirs, const QStringList &removedFiles,
+                                 std::vector<FSEntry> &newDirs, std::vector<FSEntry> &newFiles,
+                                 const QStringList &modifiedFiles)
+{
+    if(removedDirs.count() || removedFiles.count()) {
+        QStringList filePaths;
+        auto dirIndices = eraseEntries(dirEntryVec, dirIndex, removedDirs, nullptr);
+        auto fileIndices = eraseEntries(fileEntryVec, fileIndex, removedFiles, &filePaths);
+        emit entriesRemoved(dirIndices, fileIndices, filePaths);
+    }
+    if(newDirs.size() || newFiles.size()) {
+        auto dirIndices = merge_sorted(dirEntryVec, newDirs, std::bind(dirCompareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+        auto fileIndices = merge_sorted(fileEntryVec, newFiles, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+        if(dirIndices.count())
+            dirIndex.invalidateFrom(dirIndices.first());
+        if(fileIndices.count())
+            fileIndex.invalidateFrom(fileIndices.first());
+        emit entriesInserted(dirIndices, fileIndices);
+    }
+    for(auto &path : modifiedFiles)
+        updateFileEntry(path);
+}
+
+// recursive mode: anything under a hidden directory is skipped by the loader
+bool DirectoryManager::isHiddenSubpath(const QString &path) const {
+    if(settings->showHiddenFiles())
+        return false;
+    QString relativePath = path.mid(mDirectoryPath.length() + 1);
+    return relativePath.startsWith(".") || relativePath.contains("/.");
+}
+
+// recursive mode: a directory showed up, list it in the background.
+// Shares the cancel flag & id with the main load, so it is dropped on directory change.
+// The watch goes on first so nothing created while listing is missed; its
+// subdirectories get theirs as the loader finds them.
+void DirectoryManager::loadSubtree(const QString &dirPath) {
+    if(watcher)
+        watcher->addSubdirectories(QStringList() << dirPath);
+    auto loader = new DirectoryLoader(dirPath, true, filter, settings->showHiddenFiles(),
+                                      mLoaderStats, loadCancelled, loadId);
+    connect(loader, &DirectoryLoader::entriesReady, this, &DirectoryManager::onSubtreeReady, Qt::QueuedConnection);
+    loader->setAutoDelete(true);
+    pool->start(loader);
+}
+
+void DirectoryManager::onSubtreeReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id) {
+    if(id != loadId || mListSource != SOURCE_DIRECTORY_RECURSIVE)
+        return;
+    dropOverridden(files, dirs);
+    // only files are listed, dirs are there for the watcher
+    if(watcher && !dirs.empty()) {
+        QStringList dirPaths;
+        for(auto &dir : dirs)
+            dirPaths << dir.path;
+        watcher->addSubdirectories(dirPaths);
+    }
+    // some of them may have been picked up by the watcher already
+    files.erase(std::remove_if(files.begin(), files.end(), [this](const FSEntry &e) {
+        return containsFile(e.path);
+    }), files.end());
+    if(files.empty())
+        return;
+    if(mEntriesHaveStats && !mLoaderStats)
+        loadEntryStats(files);
+    std::vector<FSEntry> newDirs;
+    applyDiff(QStringList(), QStringList(), newDirs, files, QStringList());
+}
+
+// files that lived under any of dirPaths; one pass over the list
+void DirectoryManager::collectRemovedFiles(const QSet<QString> &dirPaths, QStringList &filePaths) const {
+    int rootLength = mDirectoryPath.length();
+    for(auto &entry : fileEntryVec) {
+        QString parent = entry.path;
+        int slash;
+        while((slash = parent.lastIndexOf('/')) > rootLength) {
+            parent.truncate(slash);
+            if(dirPaths.contains(parent)) {
+                filePaths << entry.path;
+                break;
+            }
+        }
+    }
 }
@@ -7,17 +7,25 @@
 #include <QSize>
 #include <QDebug>
 #include <QDateTime>
-#include <QRegularExpression>
+#include <QThreadPool>
+#include <QSet>
+#include <QTimer>
 
 #include <vector>
 #include <string>
 #include <iostream>
 #include <filesystem>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "settings.h"
 #include "watchers/directorywatcher.h"
+#include "directoryloader.h"
+#include "entryindex.h"
+#include "directorysnapshot.h"
 #include "utils/stuff.h"
+#include "utils/extensionfilter.h"
 #include "sourcecontainers/fsentry.h"
 
 #ifdef Q_OS_WIN32
@@ -40,6 +48,7 @@ class DirectoryManager : public QObject {
     Q_OBJECT
 public:
     DirectoryManager();
+    ~DirectoryManager();
     // ignored if the same dir is already opened
     bool setDirectory(QString);
     bool setDirectoryRecursive(QString);
@@ -57,6 +66,7 @@ public:
     QString nextOfFile(QString filePath) const;
     QString prevOfDir(QString filePath) const;
     QString nextOfDir(QString filePath) const;
+    // emits sortingChanged()
     void sortEntryLists();
     QDateTime lastModified(QString filePath) const;
 
@@ -90,18 +100,68 @@ public:
 
     QStringList fileList() const;
 
+    // when enabled setDirectory() returns right away and the entries
+    // arrive in batches via entriesInserted(); loaded() marks the end.
+    // Big directories are also snapshotted to disk for a quick reopen.
+    void setAsyncLoading(bool mode);
+    bool isLoading() const;
+
 private:
-    QRegularExpression regex;
+    ExtensionFilter filter;
     QCollator collator;
     std::vector<FSEntry> fileEntryVec, dirEntryVec;
+    EntryIndex fileIndex, dirIndex;
     const FSEntry defaultEntry;
     QString mDirectoryPath;
-
+    QThreadPool *pool;
+    std::shared_ptr<std::atomic<bool>> loadCancelled;
+    quint64 loadId;
+    bool mAsyncLoading, mLoading;
+    // size & mtime are only read when sorting needs them
+    bool mLoaderStats, mEntriesHaveStats;
+    // paths changed by us while the listing is still coming in
+    QSet<QString> loadingOverrides;
+    // watcher creates / deletes waiting to be applied as one batch
+    QSet<QString> pendingChanges;
+    QTimer changeTimer;
+    // recursive mode: subdirectories seen by the loader, watched once it is done
+    QStringList loadedSubdirs;
+    // a snapshot was shown, waiting for the rescan to compare against
+    bool mReconciling;
+    // rescan matched the snapshot, no need to write it again
+    bool mSnapshotUnchanged;
+    DirectorySnapshot::Stamp snapshotStamp;
+    const int CHANGE_BATCH_INTERVAL = 50;
+
+    // the one in use; network mounts get the polling one
     DirectoryWatcher* watcher;
+    DirectoryWatcher *nativeWatcher, *pollingWatcher;
     void readSettings();
     SortingMode mSortingMode;
     FileListSource mListSource;
     void loadEntryList(QString directoryPath, bool recursive);
+    void cancelLoading();
+    void overrideLoading(const QString &path);
+    bool sortNeedsStats(SortingMode mode) const;
+    void loadEntryStats(std::vector<FSEntry> &entries);
+    void setSortKey(FSEntry &entry) const;
+    QList<int> sortEntries(std::vector<FSEntry> &vec, EntryIndex &index, CompareFunction cmpFn);
+    void queueChange(const QString &path);
+    void applyDiff(const QStringList &removedDirs, const QStringList &removedFiles,
+                   std::vector<FSEntry> &newDirs, std::vector<FSEntry> &newFiles,
+                   const QStringList &modifiedFiles);
+    void dropOverridden(std::vector<FSEntry> &files, std::vector<FSEntry> &dirs) const;
+    void reconcile(std::vector<FSEntry> &files, std::vector<FSEntry> &dirs);
+    QList<int> adoptSnapshot(std::vector<FSEntry> &vec, EntryIndex &index, std::vector<FSEntry> &snapshot, CompareFunction cmpFn);
+    void diffEntries(std::vector<FSEntry> &current, const EntryIndex &index, std::vector<FSEntry> &fresh,
+                     QStringList &removed, std::vector<FSEntry> &added, QStringList *modified) const;
+    QByteArray snapshotSignature() const;
+    QString snapshotDir() const;
+    void saveSnapshot();
+    bool isHiddenSubpath(const QString &path) const;
+    void loadSubtree(const QString &dirPath);
+    void collectRemovedFiles(const QSet<QString> &dirPaths, QStringList &filePaths) const;
+    QList<int> eraseEntries(std::vector<FSEntry> &vec, EntryIndex &index, const QStringList &paths, QStringList *erasedPaths);
 
     bool path_entry_compare(const FSEntry &e1, const FSEntry &e2) const;
     bool path_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const;
@@ -110,25 +170,35 @@ private:
     bool date_entry_compare(const FSEntry &e1, const FSEntry &e2) const;
     bool date_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const;
     CompareFunction compareFunction();
+    CompareFunction dirCompareFunction();
     bool size_entry_compare(const FSEntry &e1, const FSEntry &e2) const;
     bool size_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const;
     void startFileWatcher(QString directoryPath);
     void stopFileWatcher();
 
-    void addEntriesFromDirectory(std::vector<FSEntry> &entryVec, QString directoryPath);
-    void addEntriesFromDirectoryRecursive(std::vector<FSEntry> &entryVec, QString directoryPath);
     bool checkFileRange(int index) const;
     bool checkDirRange(int index) const;
 
 private slots:
+    void onSnapshotReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id);
+    void onEntriesReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id);
+    void onLoaderFinished(quint64 id);
+    void onSubtreeReady(std::vector<FSEntry> files, std::vector<FSEntry> dirs, quint64 id);
+    void applyChanges();
     void onFileAddedExternal(QString fileName);
     void onFileRemovedExternal(QString fileName);
     void onFileModifiedExternal(QString fileName);
     void onFileRenamedExternal(QString oldFileName, QString newFileName);
 
 signals:
+    void loadStarted(const QString &path);
+    // indices are final positions after the merge, in ascending order
+    void entriesInserted(QList<int> dirIndices, QList<int> fileIndices);
+    // indices are positions before the removal, ascending; filePaths match fileIndices
+    void entriesRemoved(QList<int> dirIndices, QList<int> fileIndices, QStringList filePaths);
     void loaded(const QString &path);
-    void sortingChanged();
+    // entries were re-sorted in place; order[newIndex] == oldIndex
+    void sortingChanged(QList<int> dirOrder, QList<int> fileOrder);
     void fileRemoved(QString filePath, int);
     void fileModified(QString filePath);
     void fileAdded(QString filePath);
@@ -0,0 +1,129 @@
+#include "directorysnapshot.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDir>
+#include <QDebug>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const quint32 MAGIC = 0x51534e50; // "QSNP"
+    const quint16 VERSION = 1;
+    // sanity limit for the stored entry count
+    const quint32 MAX_COUNT = 50000000;
+    // the count is not trusted for preallocation; a corrupt file would
+    // otherwise reserve gigabytes before the read runs out of data
+    const quint32 MAX_RESERVE = 1 << 20;
+
+    bool readEntries(QDataStream &in, const QString &pathPrefix, bool isDirectory, std::vector<FSEntry> &entries) {
+        quint32 count;
+        in >> count;
+        if(in.status() != QDataStream::Ok || count > MAX_COUNT)
+            return false;
+        entries.reserve(qMin(count, MAX_RESERVE));
+        QString name;
+        quint64 size;
+        qint64 modifyTime;
+        for(quint32 i = 0; i < count; i++) {
+            in >> name >> size >> modifyTime;
+            if(in.status() != QDataStream::Ok)
+                return false;
+            entries.emplace_back(pathPrefix + name, name, size,
+                                 fs::file_time_type(fs::file_time_type::duration(modifyTime)), isDirectory);
+        }
+        return true;
+    }
+
+    void writeEntries(QDataStream &out, const std::vector<FSEntry> &entries) {
+        out << static_cast<quint32>(entries.size());
+        for(auto &entry : entries) {
+            out << entry.name << static_cast<quint64>(entry.size)
+                << static_cast<qint64>(entry.modifyTime.time_since_epoch().count());
+        }
+    }
+}
+
+DirectorySnapshot::Stamp DirectorySnapshot::stamp(const QString &dirPath) {
+    Stamp dirStamp;
+    QFileInfo info(dirPath);
+    if(info.exists()) {
+        dirStamp.modified = info.lastModified().toMSecsSinceEpoch();
+        dirStamp.changed = info.metadataChangeTime().toMSecsSinceEpoch();
+    }
+    return dirStamp;
+}
+
+QString DirectorySnapshot::filePath(const QString &cacheDir, const QString &dirPath) {
+    QString id = QCryptographicHash::hash(dirPath.toUtf8(), QCryptographicHash::Md5).toHex();
+    return cacheDir + id + ".snapshot";
+}
+
+bool DirectorySnapshot::read(const QString &snapshotFile, const QString &dirPath, const QByteArray &signature,
+                             std::vector<FSEntry> &files, std::vector<FSEntry> &dirs)
+{
+    QFile file(snapshotFile);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    quint32 magic;
+    quint16 version;
+    QString storedPath;
+    QByteArray storedSignature;
+    Stamp storedStamp;
+    in >> magic >> version;
+    if(magic != MAGIC || version != VERSION)
+        return false;
+    in >> storedPath >> storedSignature >> storedStamp.modified >> storedStamp.changed;
+    if(in.status() != QDataStream::Ok || storedPath != dirPath || storedSignature != signature)
+        return false;
+    Stamp dirStamp = stamp(dirPath);
+    if(!dirStamp.isValid() || !(dirStamp == storedStamp))
+        return false;
+    QString pathPrefix = dirPath.endsWith("/") ? dirPath : dirPath + "/";
+    if(!readEntries(in, pathPrefix, true, dirs) || !readEntries(in, pathPrefix, false, files)) {
+        qDebug() << "[DirectorySnapshot] corrupt snapshot:" << snapshotFile;
+        files.clear();
+        dirs.clear();
+        return false;
+    }
+    return true;
+}
+
+bool DirectorySnapshot::write(const QString &snapshotFile, const QString &dirPath, const QByteArray &signature, Stamp dirStamp,
+                              const std::vector<FSEntry> &files, const std::vector<FSEntry> &dirs)
+{
+    QDir().mkpath(QFileInfo(snapshotFile).absolutePath());
+    // readers never see a half written file
+    QSaveFile file(snapshotFile);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    QDataStream out(&file);
+    out << MAGIC << VERSION << dirPath << signature << dirStamp.modified << dirStamp.changed;
+    writeEntries(out, dirs);
+    writeEntries(out, files);
+    if(out.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+DirectorySnapshotWriter::DirectorySnapshotWriter(QString _snapshotFile, QString _dirPath, QByteArray _signature, DirectorySnapshot::Stamp _dirStamp,
+                                                 std::vector<FSEntry> _files, std::vector<FSEntry> _dirs)
+    : snapshotFile(_snapshotFile),
+      dirPath(_dirPath),
+      signature(_signature),
+      dirStamp(_dirStamp),
+      files(std::move(_files)),
+      dirs(std::move(_dirs))
+{
+}
+
+void DirectorySnapshotWriter::run() {
+    if(!DirectorySnapshot::write(snapshotFile, dirPath, signature, dirStamp, files, dirs))
+        qDebug() << "[DirectorySnapshot] could not write" << snapshotFile;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/* Compact on-disk copy of a directory listing.
+ *
+ * Lets a big directory show up right away on reopen: the snapshot is read
+ * first and the real listing is done afterwards, in the background, to
+ * catch up with whatever changed (see DirectoryManager).
+ *
+ * A snapshot is only used when
+ *   - the directory's mtime & ctime are the same as when it was taken, and
+ *   - it was written with the same signature (filter, hidden files, sort
+ *     mode, locale...), since entries are stored in their sorted order.
+ * Collation keys are opaque so they are not stored; entries read back
+ * have no sortKey until the rescan fills it in.
+ */
+
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QRunnable>
+#include <vector>
+#include "sourcecontainers/fsentry.h"
+
+class DirectorySnapshot {
+public:
+    struct Stamp {
+        qint64 modified = 0, changed = 0;
+        bool isValid() const { return modified || changed; }
+        bool operator==(const Stamp &other) const { return modified == other.modified && changed == other.changed; }
+    };
+
+    static Stamp stamp(const QString &dirPath);
+    // where the snapshot for dirPath lives inside cacheDir
+    static QString filePath(const QString &cacheDir, const QString &dirPath);
+
+    static bool read(const QString &snapshotFile, const QString &dirPath, const QByteArray &signature,
+                     std::vector<FSEntry> &files, std::vector<FSEntry> &dirs);
+    static bool write(const QString &snapshotFile, const QString &dirPath, const QByteArray &signature, Stamp dirStamp,
+                      const std::vector<FSEntry> &files, const std::vector<FSEntry> &dirs);
+
+    // directories smaller than this list fast enough as they are
+    static const size_t MIN_ENTRIES = 2000;
+};
+
+// writes a copy of the entries from a pool thread
+class DirectorySnapshotWriter : public QRunnable {
+public:
+    DirectorySnapshotWriter(QString _snapshotFile, QString _dirPath, QByteArray _signature, DirectorySnapshot::Stamp _dirStamp,
+                            std::vector<FSEntry> _files, std::vector<FSEntry> _dirs);
+    void run() override;
+
+private:
+    QString snapshotFile, dirPath;
+    QByteArray signature;
+    DirectorySnapshot::Stamp dirStamp;
+    std::vector<FSEntry> files, dirs;
+};
@@ -0,0 +1,53 @@
+#include "entryindex.h"
+
+EntryIndex::EntryIndex(const std::vector<FSEntry> &_entries)
+    : entries(_entries),
+      validCount(0)
+{
+}
+
+int EntryIndex::indexOf(const QString &path) const {
+    auto it = hash.constFind(path);
+    if(it != hash.constEnd()) {
+        int index = it.value();
+        // stale positions are never below validCount, see invalidateFrom()
+        if(index < validCount)
+            return index;
+        if(index < static_cast<int>(entries.size()) && entries[index].path == path)
+            return index;
+    }
+    if(validCount == static_cast<int>(entries.size()))
+        return -1;
+    update();
+    return hash.value(path, -1);
+}
+
+bool EntryIndex::contains(const QString &path) const {
+    return indexOf(path) != -1;
+}
+
+void EntryIndex::invalidateFrom(int pos) {
+    if(pos < validCount)
+        validCount = qMax(pos, 0);
+}
+
+void EntryIndex::remove(const QString &path, int pos) {
+    hash.remove(path);
+    invalidateFrom(pos);
+}
+
+void EntryIndex::clear() {
+    hash.clear();
+    validCount = 0;
+}
+
+void EntryIndex::update() const {
+    int count = static_cast<int>(entries.size());
+    if(validCount == 0) {
+        hash.clear();
+        hash.reserve(count);
+    }
+    for(int i = validCount; i < count; i++)
+        hash.insert(entries[i].path, i);
+    validCount = count;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+/* path -> position lookup for one of DirectoryManager's entry vectors.
+ *
+ * The hash is only trusted for positions below validCount. Anything that
+ * moves entries around just lowers validCount; the rest gets re-indexed
+ * on the next lookup that needs it. So a burst of inserts costs one pass
+ * over the tail instead of one per insert.
+ */
+
+#include <QHash>
+#include <QString>
+#include <vector>
+#include "sourcecontainers/fsentry.h"
+
+class EntryIndex {
+public:
+    explicit EntryIndex(const std::vector<FSEntry> &_entries);
+    int indexOf(const QString &path) const;
+    bool contains(const QString &path) const;
+    // entries at pos and after it have moved
+    void invalidateFrom(int pos);
+    // call after the entry was erased from the vector
+    void remove(const QString &path, int pos);
+    void clear();
+
+private:
+    const std::vector<FSEntry> &entries;
+    mutable QHash<QString, int> hash;
+    mutable int validCount;
+    void update() const;
+};
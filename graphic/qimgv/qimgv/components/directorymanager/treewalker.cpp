@@ -0,0 +1,99 @@
+#include "treewalker.h"
+
+#include <QThread>
+#include <thread>
+
+TreeWalker::TreeWalker(VisitFunction _visit, int _threadCount)
+    : visit(_visit),
+      mThreadCount(_threadCount),
+      pending(0),
+      queued(0),
+      stopped(false)
+{
+    if(mThreadCount <= 0)
+        mThreadCount = qBound(1, QThread::idealThreadCount(), MAX_THREADS);
+    for(int i = 0; i < mThreadCount; i++)
+        workers.emplace_back(new Worker());
+}
+
+int TreeWalker::threadCount() const {
+    return mThreadCount;
+}
+
+void TreeWalker::walk(const QString &rootPath) {
+    stopped = false;
+    pending = 1;
+    queued = 1;
+    workers[0]->tasks.push_back(rootPath);
+    std::vector<std::thread> threads;
+    for(int i = 1; i < mThreadCount; i++)
+        threads.emplace_back(&TreeWalker::run, this, i);
+    run(0);
+    for(auto &thread : threads)
+        thread.join();
+    for(auto &worker : workers)
+        worker->tasks.clear();
+}
+
+void TreeWalker::run(int self) {
+    while(!stopped) {
+        QString task;
+        if(!pop(self, task) && !steal(self, task)) {
+            // somebody is still listing a directory and may push more work
+            std::unique_lock<std::mutex> lock(idleMutex);
+            idle.wait(lock, [this]() { return stopped || pending == 0 || queued > 0; });
+            if(pending == 0)
+                return;
+            continue;
+        }
+        QStringList subdirs;
+        if(!visit(self, task, subdirs)) {
+            stopped = true;
+            wakeIdle();
+            return;
+        }
+        if(!subdirs.isEmpty()) {
+            // counted before this task is released so pending can't hit 0 early
+            pending += subdirs.count();
+            {
+                std::lock_guard<std::mutex> lock(workers[self]->mutex);
+                for(auto &dir : subdirs)
+                    workers[self]->tasks.push_back(dir);
+            }
+            queued += subdirs.count();
+            wakeIdle();
+        }
+        if(--pending == 0)
+            wakeIdle();
+    }
+}
+
+void TreeWalker::wakeIdle() {
+    // taking the mutex makes sure a worker can't miss this between checking and waiting
+    std::lock_guard<std::mutex> lock(idleMutex);
+    idle.notify_all();
+}
+
+bool TreeWalker::pop(int self, QString &task) {
+    std::lock_guard<std::mutex> lock(workers[self]->mutex);
+    if(workers[self]->tasks.empty())
+        return false;
+    task = std::move(workers[self]->tasks.back());
+    workers[self]->tasks.pop_back();
+    queued--;
+    return true;
+}
+
+bool TreeWalker::steal(int self, QString &task) {
+    for(int i = 1; i < mThreadCount; i++) {
+        Worker &victim = *workers[(self + i) % mThreadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(victim.tasks.empty())
+            continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        queued--;
+        return true;
+    }
+    return false;
+}
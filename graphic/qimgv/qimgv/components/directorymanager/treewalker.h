@@ -0,0 +1,60 @@
+#pragma once
+
+/* Visits a directory tree from several threads at once.
+ *
+ * Every directory is a separate task. Each worker owns a deque: subdirectories
+ * it finds go to the back, and it takes its next task from the back as well,
+ * so a worker keeps descending into the part of the tree it is already in.
+ * A worker that runs dry steals from the front of another worker's deque,
+ * where the oldest (and usually biggest) subtrees are.
+ *
+ * visit() is called concurrently. It gets the index of the calling worker
+ * (0 is always the thread that called walk()), lists one directory and
+ * appends the subdirectories to descend into. Returning false stops the walk.
+ */
+
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class TreeWalker {
+public:
+    typedef std::function<bool(int worker, const QString &dirPath, QStringList &subdirs)> VisitFunction;
+
+    // threadCount <= 0 picks one based on the cpu count
+    explicit TreeWalker(VisitFunction _visit, int _threadCount = 0);
+
+    int threadCount() const;
+    // blocks until the whole tree was visited or visit() returned false
+    void walk(const QString &rootPath);
+
+    static const int MAX_THREADS = 8;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<QString> tasks;
+    };
+
+    void run(int self);
+    bool pop(int self, QString &task);
+    bool steal(int self, QString &task);
+    void wakeIdle();
+
+    VisitFunction visit;
+    int mThreadCount;
+    std::vector<std::unique_ptr<Worker>> workers;
+    // tasks that are queued or being visited
+    std::atomic<long> pending;
+    // tasks that are queued only; idle workers sleep until this is non-zero
+    std::atomic<long> queued;
+    std::atomic<bool> stopped;
+    std::mutex idleMutex;
+    std::condition_variable idle;
+};
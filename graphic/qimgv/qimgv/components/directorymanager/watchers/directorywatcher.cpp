@@ -2,6 +2,15 @@
 
 #if defined(__linux__) || defined(__FreeBSD__)
 #include "linux/linuxwatcher.h"
+#include "polling/pollingwatcher.h"
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <QFile>
+#include <QFileInfo>
+#else
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
 #elif _WIN32
 #include "windows/windowswatcher.h"
 #elif __unix__
@@ -20,7 +29,8 @@
 DirectoryWatcherPrivate::DirectoryWatcherPrivate(DirectoryWatcher* qq, WatcherWorker* w) :
     q_ptr(qq),
     worker(w),
-    workerThread(new QThread())
+    workerThread(new QThread()),
+    recursive(false)
 {
 }
 
@@ -49,6 +59,86 @@ DirectoryWatcher *DirectoryWatcher::newInstance()
     return watcher;
 }
 
+DirectoryWatcher *DirectoryWatcher::newPollingInstance()
+{
+#if defined(__linux__) || defined(__FreeBSD__)
+    return new PollingWatcher();
+#else
+    return newInstance();
+#endif
+}
+
+#if defined(__linux__) || defined(__FreeBSD__)
+// FUSE is used for local filesystems too (ntfs-3g, exfat, appimages...),
+// inotify works fine on those. Only these are polled.
+static bool isNetworkFuseType(const QString &subtype) {
+    static const QStringList networkTypes = { "sshfs", "rclone", "s3fs", "gcsfuse", "gvfsd-fuse",
+                                              "curlftpfs", "davfs", "smbnetfs", "glusterfs", "cephfs" };
+    return networkTypes.contains(subtype);
+}
+#endif
+
+#if defined(__linux__)
+// "fuse.sshfs" -> "sshfs" for the mount the path is on; empty if not found
+static QString fuseSubtype(const QString &path) {
+    QFile file("/proc/self/mountinfo");
+    if(!file.open(QIODevice::ReadOnly))
+        return QString();
+    QString target = QFileInfo(path).canonicalFilePath();
+    QString subtype;
+    int bestLength = -1;
+    // id parent major:minor root mountpoint options [optional...] - fstype source superoptions
+    for(auto &line : QString::fromUtf8(file.readAll()).split('\n')) {
+        QStringList fields = line.split(' ');
+        int separator = fields.indexOf("-");
+        if(fields.count() < 5 || separator == -1 || separator + 1 >= fields.count())
+            continue;
+        QString mountPoint = fields[4].replace("\\040", " ");
+        bool contains = (target == mountPoint || mountPoint == "/" ||
+                         target.startsWith(mountPoint + "/"));
+        // the last (most recent) of several mounts on the same point wins
+        if(!contains || mountPoint.length() < bestLength)
+            continue;
+        bestLength = mountPoint.length();
+        QString fsType = fields[separator + 1];
+        subtype = fsType.startsWith("fuse.") ? fsType.mid(5) : QString();
+    }
+    return subtype;
+}
+#endif
+
+bool DirectoryWatcher::isRemotePath(const QString &path)
+{
+#if defined(__linux__)
+    // from linux/magic.h & fs/smb
+    const long NFS_SUPER_MAGIC  = 0x6969;
+    const long SMB_SUPER_MAGIC  = 0x517B;
+    const long CIFS_SUPER_MAGIC = 0xFF534D42;
+    const long SMB2_SUPER_MAGIC = 0xFE534D42;
+    // sshfs, rclone & co, but also local ones; checked by subtype below
+    const long FUSE_SUPER_MAGIC = 0x65735546;
+    struct statfs fs;
+    if(statfs(path.toUtf8().constData(), &fs) != 0)
+        return false;
+    long type = static_cast<long>(fs.f_type) & 0xFFFFFFFF;
+    if(type == FUSE_SUPER_MAGIC)
+        return isNetworkFuseType(fuseSubtype(path));
+    return type == NFS_SUPER_MAGIC || type == SMB_SUPER_MAGIC || type == CIFS_SUPER_MAGIC ||
+           type == SMB2_SUPER_MAGIC;
+#elif defined(__FreeBSD__)
+    struct statfs fs;
+    if(statfs(path.toUtf8().constData(), &fs) != 0)
+        return false;
+    QString type = fs.f_fstypename;
+    if(type.startsWith("fusefs."))
+        return isNetworkFuseType(type.mid(7));
+    return type == "nfs" || type == "smbfs";
+#else
+    Q_UNUSED(path)
+    return false;
+#endif
+}
+
 void DirectoryWatcher::setWatchPath(const QString& path) {
     Q_D(DirectoryWatcher);
     d->currentDirectory = path;
@@ -59,6 +149,20 @@ QString DirectoryWatcher::watchPath() const {
     return d->currentDirectory;
 }
 
+void DirectoryWatcher::setRecursive(bool mode) {
+    Q_D(DirectoryWatcher);
+    d->recursive = mode;
+}
+
+bool DirectoryWatcher::isRecursive() const {
+    Q_D(const DirectoryWatcher);
+    return d->recursive;
+}
+
+void DirectoryWatcher::addSubdirectories(const QStringList &dirPaths) {
+    Q_UNUSED(dirPaths)
+}
+
 void DirectoryWatcher::observe()
 {
     Q_D(DirectoryWatcher);
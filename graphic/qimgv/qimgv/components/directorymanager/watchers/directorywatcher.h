@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
 
 class DirectoryWatcherPrivate;
 
@@ -8,6 +9,10 @@ class DirectoryWatcher : public QObject {
     Q_OBJECT
 public:
     static DirectoryWatcher* newInstance();
+    // for paths where the native backend can't see changes made by others
+    static DirectoryWatcher* newPollingInstance();
+    // network mounts (nfs, smb, fuse...)
+    static bool isRemotePath(const QString &path);
 
     virtual ~DirectoryWatcher();
 
@@ -15,6 +20,15 @@ public:
     virtual QString watchPath() const;
     bool isObserving();
 
+    // Recursive mode also reports changes in subdirectories; names are then
+    // paths relative to watchPath(). Must be set before setWatchPath().
+    // Only the linux backend supports it, others keep watching the top dir.
+    void setRecursive(bool mode);
+    bool isRecursive() const;
+    // subdirectories to watch (full paths). New ones are reported as created
+    // but not watched until they are passed in here as well
+    virtual void addSubdirectories(const QStringList &dirPaths);
+
 public Q_SLOTS:
     void observe();
     void stopObserving();
@@ -12,43 +12,24 @@
   * Time to wait for rename event. If event take time longer
   * than specified then event will be considered as remove event
   */
-
-// TODO: this may break event order.
-// Implement a proper queue.
 #define EVENT_MOVE_TIMEOUT      150 // ms
+/**
+  * Modify events for a file are merged until it was left alone for this long
+  */
 #define EVENT_MODIFY_TIMEOUT    150 // ms
 
 LinuxWatcherPrivate::LinuxWatcherPrivate(LinuxWatcher* qq) :
     DirectoryWatcherPrivate(qq, new LinuxWorker()),
     watcher(-1),
-    watchObject(-1)
+    watchLimitReached(false)
 {
     watcher = inotify_init();
-}
-
-int LinuxWatcherPrivate::indexOfWatcherEvent(uint cookie) const {
-    for (int i = 0; i < watcherEvents.size(); ++i) {
-        auto event = watcherEvents.at(i);
-        if (event->cookie() == cookie) {
-            return i;
-        }
-    }
-    return -1;
-}
-
-int LinuxWatcherPrivate::indexOfWatcherEvent(const QString& name) const {
-    for (int i = 0; i < watcherEvents.size(); ++i) {
-        auto event = watcherEvents.at(i);
-        if (event->name() == name) {
-            return i;
-        }
-    }
-    return -1;
+    clock.start();
+    deadlineTimer.setSingleShot(true);
+    connect(&deadlineTimer, &QTimer::timeout, this, &LinuxWatcherPrivate::emitDueEvents);
 }
 
 void LinuxWatcherPrivate::dispatchFilesystemEvent(LinuxFsEvent* e) {
-    Q_Q(LinuxWatcher);
-
     uint dataOffset = 0;
     QScopedPointer<LinuxFsEvent> event(e);
 
@@ -60,7 +41,19 @@ void LinuxWatcherPrivate::dispatchFilesystemEvent(LinuxFsEvent* e) {
         QString name    = notify_event->name;
         uint cookie     = notify_event->cookie;
         bool isDirEvent = mask & IN_ISDIR;
-        
+
+        // Watch is gone: directory deleted, or we removed it ourselves
+        if (mask & IN_IGNORED) {
+            forgetWatch(notify_event->wd);
+            continue;
+        }
+        // Late event from a watch that was already removed
+        auto dir = watchDirs.constFind(notify_event->wd);
+        if (dir == watchDirs.constEnd())
+            continue;
+        if (!dir.value().isEmpty())
+            name = dir.value() + "/" + name;
+
         // Skip events for directories and files that isn't in filter range
         /*if((isDirEvent) && !(mask & IN_MOVED_TO) ) {
             continue;
@@ -73,88 +66,203 @@ void LinuxWatcherPrivate::dispatchFilesystemEvent(LinuxFsEvent* e) {
         } else if (mask & IN_DELETE) {
             handleDeleteEvent(name);
         } else if (mask & IN_MOVED_FROM) {
-            handleMovedFromEvent(name, cookie);
+            handleMovedFromEvent(name, cookie, isDirEvent);
         } else if (mask & IN_MOVED_TO) {
-            handleMovedToEvent(name, cookie);
+            handleMovedToEvent(name, cookie, isDirEvent);
         }
     }
+    // whole read is queued, now send out whatever is due
+    emitDueEvents();
 }
 
 void LinuxWatcherPrivate::handleModifyEvent(const QString &name) {
-    // Find the same event in the list by file name
-    int eventIndex = indexOfWatcherEvent(name);
-    if (eventIndex == -1) {
-        // This is this first modify event for the current file
-        int timerId = startTimer(EVENT_MODIFY_TIMEOUT);
-        auto event = new WatcherEvent(name, timerId, WatcherEvent::Modify);
-        watcherEvents.append(QSharedPointer<WatcherEvent>(event));
-    } else {
-        auto event = watcherEvents.at(eventIndex);
-        // Restart timer again
-        killTimer(event->timerId());
-        int timerId = startTimer(EVENT_MODIFY_TIMEOUT);
-        event->setTimerId(timerId);
+    auto last = lastEventByName.find(name);
+    if (last != lastEventByName.end() && last.value()->type == WatcherEvent::Modify) {
+        // Still being written; merge into one event at the back of the queue
+        erase(last.value());
     }
+    enqueue(WatcherEvent::Modify, name, 0, false, EVENT_MODIFY_TIMEOUT);
 }
 
 void LinuxWatcherPrivate::handleDeleteEvent(const QString &name) {
-    Q_Q(LinuxWatcher);
-    emit q->fileDeleted(name);
+    auto last = lastEventByName.find(name);
+    if (last != lastEventByName.end() && last.value()->type == WatcherEvent::Modify) {
+        // No point reporting changes to a file that is gone
+        erase(last.value());
+    }
+    enqueue(WatcherEvent::Delete, name, 0, false, 0);
 }
 
 void LinuxWatcherPrivate::handleCreateEvent(const QString &name) {
-    Q_Q(LinuxWatcher);
-    emit q->fileCreated(name);
+    enqueue(WatcherEvent::Create, name, 0, false, 0);
 }
 
-void LinuxWatcherPrivate::handleMovedFromEvent(const QString &name, uint cookie) {
-    int timerId = startTimer(EVENT_MOVE_TIMEOUT);
-    // Save timer id to find out later which event timer is running
-    auto event = new WatcherEvent(name, cookie, timerId, WatcherEvent::MovedFrom);
-    watcherEvents.append(QSharedPointer<WatcherEvent>(event));
+void LinuxWatcherPrivate::handleMovedFromEvent(const QString &name, uint cookie, bool isDir) {
+    enqueue(WatcherEvent::MovedFrom, name, cookie, isDir, EVENT_MOVE_TIMEOUT);
 }
 
-void LinuxWatcherPrivate::handleMovedToEvent(const QString &name, uint cookie) {
-    Q_Q(LinuxWatcher);
-
+void LinuxWatcherPrivate::handleMovedToEvent(const QString &name, uint cookie, bool isDir) {
     // Check if file waiting to be renamed
-    int eventIndex = indexOfWatcherEvent(cookie);
-    if (eventIndex == -1) {
+    auto move = pendingMoves.find(cookie);
+    if (move == pendingMoves.end()) {
         // No one event waiting for rename so this is a new file
-        emit q->fileCreated(name);
-    } else {
-        // Waiting for rename event is found
-        auto watcherEvent = watcherEvents.takeAt(eventIndex);
-        // Kill associated timer
-        killTimer(watcherEvent->timerId());
-        emit q->fileRenamed(watcherEvent->name(), name);
+        enqueue(WatcherEvent::Create, name, 0, isDir, 0);
+        return;
     }
+    // Turn the waiting event into a rename; it keeps its place in the queue
+    EventIterator it = move.value();
+    pendingMoves.erase(move);
+    // Watches stay on the moved directories, only their paths change
+    if (isDir && recursive)
+        renameWatches(it->name, name);
+    it->newName = name;
+    it->deadline = clock.elapsed();
+    lastEventByName.insert(name, it);
 }
 
-void LinuxWatcherPrivate::timerEvent(QTimerEvent *timerEvent) {
-    Q_Q(LinuxWatcher);
+void LinuxWatcherPrivate::enqueue(WatcherEvent::Type type, const QString &name, uint cookie, bool isDir, qint64 delay) {
+    QueuedWatcherEvent event { type, name, QString(), cookie, isDir, clock.elapsed() + delay };
+    EventIterator it = eventQueue.insert(eventQueue.end(), event);
+    lastEventByName.insert(name, it);
+    if (type == WatcherEvent::MovedFrom)
+        pendingMoves.insert(cookie, it);
+}
 
-    // Loop through waiting move events
-    int lastIndex = watcherEvents.size() - 1;
-    for (int i = lastIndex; i >= 0; --i) {
-        auto watcherEvent = watcherEvents.at(i);
+void LinuxWatcherPrivate::erase(EventIterator it) {
+    auto last = lastEventByName.find(it->name);
+    if (last != lastEventByName.end() && last.value() == it)
+        lastEventByName.erase(last);
+    if (!it->newName.isEmpty()) {
+        last = lastEventByName.find(it->newName);
+        if (last != lastEventByName.end() && last.value() == it)
+            lastEventByName.erase(last);
+    }
+    if (it->type == WatcherEvent::MovedFrom && it->newName.isEmpty())
+        pendingMoves.remove(it->cookie);
+    eventQueue.erase(it);
+}
 
-        if (watcherEvent->timerId() == timerEvent->timerId()) {
-            int type = watcherEvent->type();
-            if (type == WatcherEvent::MovedFrom) {
+// Emits from the front of the queue until it reaches something that is
+// not due yet, then re-arms the timer for that entry.
+void LinuxWatcherPrivate::emitDueEvents() {
+    Q_Q(LinuxWatcher);
+
+    qint64 now = clock.elapsed();
+    while (!eventQueue.empty() && eventQueue.front().deadline <= now) {
+        QueuedWatcherEvent event = eventQueue.front();
+        erase(eventQueue.begin());
+        switch (event.type) {
+        case WatcherEvent::Create:
+            emit q->fileCreated(event.name);
+            break;
+        case WatcherEvent::Delete:
+            emit q->fileDeleted(event.name);
+            break;
+        case WatcherEvent::Modify:
+            emit q->fileModified(event.name);
+            break;
+        case WatcherEvent::MovedFrom:
+            if (event.newName.isEmpty()) {
                 // Rename event didn't happen so treat this event as remove event
-                emit q->fileDeleted(watcherEvent->name());
-            } else if (type == WatcherEvent::Modify) {
-                emit q->fileModified(watcherEvent->name());
+                // (for a directory: it was moved somewhere we don't watch)
+                if (event.isDir && recursive)
+                    removeWatches(event.name);
+                emit q->fileDeleted(event.name);
+            } else {
+                emit q->fileRenamed(event.name, event.newName);
             }
-
-            watcherEvents.removeAt(i);
             break;
+        default:
+            break;
+        }
+    }
+    scheduleNext();
+}
+
+void LinuxWatcherPrivate::scheduleNext() {
+    if (eventQueue.empty()) {
+        deadlineTimer.stop();
+        return;
+    }
+    qint64 delay = eventQueue.front().deadline - clock.elapsed();
+    deadlineTimer.start(static_cast<int>(qMax(delay, qint64(0))));
+}
+
+// Events of the previously watched directory are meaningless now
+void LinuxWatcherPrivate::clearEvents() {
+    deadlineTimer.stop();
+    eventQueue.clear();
+    lastEventByName.clear();
+    pendingMoves.clear();
+}
+
+bool LinuxWatcherPrivate::addWatch(const QString &relativeDir) {
+    if (watchLimitReached || watchDescriptors.contains(relativeDir))
+        return false;
+    QString fullPath = relativeDir.isEmpty() ? currentDirectory : currentDirectory + "/" + relativeDir;
+    int wd = inotify_add_watch(watcher, fullPath.toStdString().data(), INOTIFY_EVENT_MASK);
+    if (wd == -1) {
+        if (errno == ENOSPC) {
+            // Don't try (and log) for every remaining directory
+            watchLimitReached = true;
+            qDebug() << TAG << "Watch limit reached, see /proc/sys/fs/inotify/max_user_watches."
+                     << "Changes in some subdirectories will be missed.";
+        } else {
+            qDebug() << TAG << "Error:" << fullPath << strerror(errno);
+        }
+        return false;
+    }
+    watchDirs.insert(wd, relativeDir);
+    watchDescriptors.insert(relativeDir, wd);
+    return true;
+}
+
+void LinuxWatcherPrivate::removeWatches(const QString &relativeDir) {
+    QString prefix = relativeDir + "/";
+    for (auto it = watchDescriptors.begin(); it != watchDescriptors.end();) {
+        if (it.key() == relativeDir || it.key().startsWith(prefix)) {
+            inotify_rm_watch(watcher, it.value());
+            watchDirs.remove(it.value());
+            it = watchDescriptors.erase(it);
+        } else {
+            ++it;
         }
     }
+}
+
+void LinuxWatcherPrivate::renameWatches(const QString &from, const QString &to) {
+    QString prefix = from + "/";
+    QList<QString> moved;
+    for (auto it = watchDescriptors.constBegin(); it != watchDescriptors.constEnd(); ++it) {
+        if (it.key() == from || it.key().startsWith(prefix))
+            moved << it.key();
+    }
+    for (auto &oldPath : moved) {
+        int wd = watchDescriptors.take(oldPath);
+        QString newPath = to + oldPath.mid(from.length());
+        watchDirs.insert(wd, newPath);
+        watchDescriptors.insert(newPath, wd);
+    }
+}
 
-    // Stop timer anyway
-    killTimer(timerEvent->timerId());
+void LinuxWatcherPrivate::forgetWatch(int wd) {
+    auto dir = watchDirs.find(wd);
+    if (dir == watchDirs.end())
+        return;
+    auto descriptor = watchDescriptors.find(dir.value());
+    if (descriptor != watchDescriptors.end() && descriptor.value() == wd)
+        watchDescriptors.erase(descriptor);
+    watchDirs.erase(dir);
+}
+
+void LinuxWatcherPrivate::removeAllWatches() {
+    for (auto wd : watchDescriptors) {
+        if (inotify_rm_watch(watcher, wd) != 0)
+            qDebug() << TAG << "Cannot remove inotify watcher instance:" << strerror(errno);
+    }
+    watchDirs.clear();
+    watchDescriptors.clear();
+    watchLimitReached = false;
 }
 
 LinuxWatcher::LinuxWatcher() : DirectoryWatcher(new LinuxWatcherPrivate(this)) {
@@ -178,27 +286,26 @@ LinuxWatcher::LinuxWatcher() : DirectoryWatcher(new LinuxWatcherPrivate(this)) {
 
 LinuxWatcher::~LinuxWatcher() {
     Q_D(LinuxWatcher);
-    int removeStatusCode = inotify_rm_watch(d->watcher, d->watchObject);
-    if (removeStatusCode != 0) {
-        qDebug() << TAG << "Cannot remove inotify watcher instance:" << strerror(errno);
-    }
+    d->removeAllWatches();
 }
 
 void LinuxWatcher::setWatchPath(const QString& path) {
     Q_D(LinuxWatcher);
     DirectoryWatcher::setWatchPath(path);
+    d->clearEvents();
 
     // Subscribe for specified filesystem events
-    if (d->watchObject != -1) {
-        int status = inotify_rm_watch(d->watcher, d->watchObject);
-        if (status == -1) {
-            qDebug() << TAG << "Error:" << strerror(errno);
-        }
-    }
+    d->removeAllWatches();
+    d->addWatch("");
+}
 
-    // Add new path to be watched by inotify
-    d->watchObject = inotify_add_watch(d->watcher, path.toStdString().data(), INOTIFY_EVENT_MASK);
-    if (d->watchObject == -1) {
-        qDebug() << TAG << "Error:" << strerror(errno);
+void LinuxWatcher::addSubdirectories(const QStringList &dirPaths) {
+    Q_D(LinuxWatcher);
+    if (!d->recursive)
+        return;
+    QString prefix = d->currentDirectory + "/";
+    for (auto &path : dirPaths) {
+        if (path.startsWith(prefix))
+            d->addWatch(path.mid(prefix.length()));
     }
 }
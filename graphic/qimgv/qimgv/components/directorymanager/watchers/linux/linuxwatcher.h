@@ -10,6 +10,7 @@ public:
     explicit LinuxWatcher();
     virtual ~LinuxWatcher();
     virtual void setWatchPath(const QString& p);
+    virtual void addSubdirectories(const QStringList &dirPaths) override;
 
 private:
     Q_DECLARE_PRIVATE(LinuxWatcher)
@@ -5,35 +5,83 @@
 #include "../directorywatcher_p.h"
 
 #include <errno.h>
+#include <list>
 #include <QDebug>
+#include <QHash>
 #include <QTimer>
+#include <QElapsedTimer>
 
 class LinuxFsEvent;
 
+/* Pending notifications are kept in one queue in the order inotify
+ * reported them and are only emitted from the front, so nothing can
+ * overtake an earlier event (e.g. a delayed "moved from" turning into
+ * a delete after the file was already re-created under the same name).
+ *
+ * Modify and moved-from events are held back for a while: modifies to
+ * wait until writes settle, moves to wait for the matching moved-to.
+ * Everything else is due right away but still waits behind them.
+ * One timer is armed for the deadline of the front entry.
+ *
+ * In recursive mode there is one inotify watch per directory; watchDirs maps
+ * it to the directory path relative to the watched root, which is prepended
+ * to the names in its events. Watches follow directories being renamed,
+ * moved out and deleted. New directories are only reported; the owner lists
+ * them off the gui thread and hands them back via addSubdirectories(),
+ * leaving out the ones it doesn't show (hidden).
+ */
+struct QueuedWatcherEvent {
+    WatcherEvent::Type type;
+    QString name;
+    // set once a moved-from is paired with its moved-to
+    QString newName;
+    uint cookie;
+    bool isDir;
+    qint64 deadline;
+};
+
 class LinuxWatcherPrivate : public DirectoryWatcherPrivate {
     Q_OBJECT
 public:
     explicit LinuxWatcherPrivate(LinuxWatcher* qq = 0);
 
-    int indexOfWatcherEvent(uint cookie) const;
-    int indexOfWatcherEvent(const QString& name) const;
-
     void handleModifyEvent(const QString& name);
     void handleDeleteEvent(const QString& name);
     void handleCreateEvent(const QString& name);
-    void handleMovedFromEvent(const QString& name, uint cookie);
-    void handleMovedToEvent(const QString& name, uint cookie);
+    void handleMovedFromEvent(const QString& name, uint cookie, bool isDir);
+    void handleMovedToEvent(const QString& name, uint cookie, bool isDir);
+    void clearEvents();
+
+    bool addWatch(const QString &relativeDir);
+    void removeWatches(const QString &relativeDir);
+    void renameWatches(const QString &from, const QString &to);
+    void forgetWatch(int wd);
+    void removeAllWatches();
 
     int watcher;
-    int watchObject;
+    // watch descriptor -> directory relative to the root ("" for the root)
+    QHash<int, QString> watchDirs;
+    QHash<QString, int> watchDescriptors;
+    bool watchLimitReached;
+
+private:
+    typedef std::list<QueuedWatcherEvent>::iterator EventIterator;
 
-    QVector<QSharedPointer<WatcherEvent>> watcherEvents;
+    std::list<QueuedWatcherEvent> eventQueue;
+    // last queued event for a name; only used to coalesce modifies
+    QHash<QString, EventIterator> lastEventByName;
+    // moved-from events still waiting for their moved-to
+    QHash<uint, EventIterator> pendingMoves;
+    QTimer deadlineTimer;
+    QElapsedTimer clock;
 
-protected:
-    virtual void timerEvent(QTimerEvent* timerEvent) override;
+    void enqueue(WatcherEvent::Type type, const QString &name, uint cookie, bool isDir, qint64 delay);
+    void erase(EventIterator it);
+    void scheduleNext();
 
 private slots:
     void dispatchFilesystemEvent(LinuxFsEvent *e);
+    void emitDueEvents();
 
 private:
     Q_DECLARE_PUBLIC(LinuxWatcher)
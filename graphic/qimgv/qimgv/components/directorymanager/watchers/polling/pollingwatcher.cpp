@@ -0,0 +1,75 @@
+#include "pollingwatcher_p.h"
+
+#define TAG     "[PollingWatcher]"
+
+PollingWatcherPrivate::PollingWatcherPrivate(PollingWatcher* qq) :
+    DirectoryWatcherPrivate(qq, new PollingWorker())
+{
+}
+
+void PollingWatcherPrivate::dispatchChanges(PollingChanges *changes) {
+    Q_Q(PollingWatcher);
+    QScopedPointer<PollingChanges> guard(changes);
+
+    // Poll of a directory we no longer watch
+    if (changes->root != currentDirectory)
+        return;
+
+    for (auto &change : changes->changes) {
+        switch (change.type) {
+        case WatcherEvent::Create:
+            emit q->fileCreated(change.name);
+            break;
+        case WatcherEvent::Delete:
+            emit q->fileDeleted(change.name);
+            break;
+        case WatcherEvent::Modify:
+            emit q->fileModified(change.name);
+            break;
+        case WatcherEvent::MovedFrom:
+            emit q->fileRenamed(change.name, change.newName);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+PollingWatcher::PollingWatcher() : DirectoryWatcher(new PollingWatcherPrivate(this)) {
+    Q_D(PollingWatcher);
+    qRegisterMetaType<PollingChanges*>("PollingChanges*");
+
+    connect(d->workerThread.data(), &QThread::started, d->worker.data(), &WatcherWorker::run);
+    d->worker.data()->moveToThread(d->workerThread.data());
+
+    auto pollingWorker = static_cast<PollingWorker*>(d->worker.data());
+    connect(pollingWorker, &PollingWorker::changesFound,
+            d, &PollingWatcherPrivate::dispatchChanges);
+
+    connect(pollingWorker, &PollingWorker::finished, d->workerThread.data(), &QThread::quit);
+
+    connect(pollingWorker, &PollingWorker::started, this, &PollingWatcher::observingStarted);
+    connect(pollingWorker, &PollingWorker::finished, this, &PollingWatcher::observingStopped);
+}
+
+PollingWatcher::~PollingWatcher() {
+}
+
+void PollingWatcher::setWatchPath(const QString& path) {
+    Q_D(PollingWatcher);
+    DirectoryWatcher::setWatchPath(path);
+    static_cast<PollingWorker*>(d->worker.data())->setRoot(path, d->recursive);
+}
+
+void PollingWatcher::addSubdirectories(const QStringList &dirPaths) {
+    Q_D(PollingWatcher);
+    if (!d->recursive)
+        return;
+    QString prefix = d->currentDirectory + "/";
+    QStringList relativeDirs;
+    for (auto &path : dirPaths) {
+        if (path.startsWith(prefix))
+            relativeDirs << path.mid(prefix.length());
+    }
+    static_cast<PollingWorker*>(d->worker.data())->addSubdirectories(relativeDirs);
+}
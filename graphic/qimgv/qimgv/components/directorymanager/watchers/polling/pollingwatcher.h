@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../directorywatcher.h"
+
+class PollingWatcherPrivate;
+
+class PollingWatcher : public DirectoryWatcher {
+    Q_OBJECT
+public:
+    explicit PollingWatcher();
+    virtual ~PollingWatcher();
+    virtual void setWatchPath(const QString& p);
+    virtual void addSubdirectories(const QStringList &dirPaths) override;
+
+private:
+    Q_DECLARE_PRIVATE(PollingWatcher)
+};
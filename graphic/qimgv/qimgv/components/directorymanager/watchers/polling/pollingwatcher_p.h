@@ -0,0 +1,35 @@
+#ifndef POLLINGWATCHER_P_H
+#define POLLINGWATCHER_P_H
+
+#include "../polling/pollingwatcher.h"
+#include "../directorywatcher_p.h"
+#include "pollingworker.h"
+
+/* Watcher for network mounts (nfs, smb, sshfs & other fuse filesystems).
+ * inotify only sees what this machine does there, changes made by other
+ * hosts never show up.
+ *
+ * The worker keeps the last listing of every watched directory and
+ * stats the directories themselves on each poll; a directory is only
+ * listed again when its mtime / ctime moved. New, removed and renamed
+ * (same inode) entries are reported like the other backends do.
+ * Rewriting a file in place does not touch the directory, so everything
+ * is listed once in a while regardless.
+ *
+ * Poll interval starts short and backs off while nothing changes; it is
+ * also kept well above the time a poll takes so a slow server is not
+ * kept busy.
+ */
+class PollingWatcherPrivate : public DirectoryWatcherPrivate {
+    Q_OBJECT
+public:
+    explicit PollingWatcherPrivate(PollingWatcher* qq = 0);
+
+private slots:
+    void dispatchChanges(PollingChanges *changes);
+
+private:
+    Q_DECLARE_PUBLIC(PollingWatcher)
+};
+
+#endif // POLLINGWATCHER_P_H
@@ -0,0 +1,290 @@
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cstring>
+
+#include <QThread>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "pollingworker.h"
+
+#define TAG                 "[PollingWatcherWorker]"
+#define MIN_INTERVAL        1000  // ms, right after something changed
+#define MAX_INTERVAL        10000 // ms, after a quiet while
+#define FULL_SCAN_INTERVAL  60000 // ms, list everything even if dir stamps didn't move
+#define LOAD_FACTOR         10    // interval is at least this many times the poll duration
+#define TICK                100   // ms, how often a sleeping worker checks for stop / new root
+
+static qint64 toNsecs(const struct timespec &time) {
+    return static_cast<qint64>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+PollingWorker::PollingWorker() :
+    requestedRecursive(false),
+    rootRequested(false),
+    recursive(false),
+    interval(MIN_INTERVAL)
+{
+}
+
+void PollingWorker::setRoot(const QString &path, bool _recursive) {
+    QMutexLocker locker(&mutex);
+    requestedRoot = path;
+    requestedRecursive = _recursive;
+    requestedSubdirs.clear();
+    rootRequested = true;
+}
+
+void PollingWorker::addSubdirectories(const QStringList &relativeDirs) {
+    QMutexLocker locker(&mutex);
+    requestedSubdirs << relativeDirs;
+}
+
+void PollingWorker::run() {
+    emit started();
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    isRunning.store(true);
+#else
+    isRunning.storeRelaxed(true);
+#endif
+
+    QElapsedTimer sinceFullScan;
+    sinceFullScan.start();
+    while (isRunning) {
+        applyRequests();
+        if (!root.isEmpty()) {
+            QElapsedTimer pollTime;
+            pollTime.start();
+            bool fullScan = sinceFullScan.hasExpired(FULL_SCAN_INTERVAL);
+            if (fullScan)
+                sinceFullScan.restart();
+
+            auto changes = new PollingChanges;
+            changes->root = root;
+            poll(*changes, fullScan);
+            if (changes->changes.isEmpty()) {
+                delete changes;
+                interval = qMin(interval * 3 / 2, MAX_INTERVAL);
+            } else {
+                emit changesFound(changes);
+                interval = MIN_INTERVAL;
+            }
+            interval = qMax(interval, static_cast<int>(pollTime.elapsed()) * LOAD_FACTOR);
+        }
+        sleep(interval);
+    }
+
+    emit finished();
+}
+
+bool PollingWorker::hasRequests() {
+    QMutexLocker locker(&mutex);
+    return rootRequested || !requestedSubdirs.isEmpty();
+}
+
+void PollingWorker::applyRequests() {
+    QMutexLocker locker(&mutex);
+    bool newRoot = rootRequested;
+    if (newRoot) {
+        root = requestedRoot;
+        recursive = requestedRecursive;
+        rootRequested = false;
+    }
+    QStringList subdirs;
+    subdirs.swap(requestedSubdirs);
+    locker.unlock();
+
+    if (newRoot) {
+        dirs.clear();
+        interval = MIN_INTERVAL;
+        if (!root.isEmpty())
+            track("", false);
+    }
+    if (recursive) {
+        for (auto &dir : subdirs) {
+            if (!isRunning || hasRequests())
+                return;
+            track(dir, false);
+        }
+    }
+}
+
+// Wakes up early when stopped or given something new to watch
+void PollingWorker::sleep(int ms) {
+    for (int slept = 0; slept < ms && isRunning && !hasRequests(); slept += TICK)
+        QThread::msleep(TICK);
+}
+
+// Stats every watched directory; only the ones whose stamp moved are listed
+void PollingWorker::poll(PollingChanges &out, bool fullScan) {
+    // directories get added / removed while going through them
+    QStringList relativeDirs = dirs.keys();
+    for (auto &relativeDir : relativeDirs) {
+        // results would be thrown away anyway
+        if (!isRunning || hasRequests())
+            return;
+        auto state = dirs.find(relativeDir);
+        if (state == dirs.end())
+            continue;
+        qint64 modified, changed;
+        // gone; reported by the parent's listing
+        if (!statDirectory(fullPath(relativeDir), modified, changed))
+            continue;
+        bool stampChanged = modified != state->modified || changed != state->changed;
+        if (!stampChanged && !state->recheck && !fullScan)
+            continue;
+        EntryMap entries;
+        if (!listDirectory(fullPath(relativeDir), entries))
+            continue;
+        state->modified = modified;
+        state->changed = changed;
+        state->recheck = stampChanged;
+        diff(relativeDir, entries, out);
+    }
+}
+
+void PollingWorker::diff(const QString &relativeDir, EntryMap &entries, PollingChanges &out) {
+    QString prefix = relativeDir.isEmpty() ? QString() : relativeDir + "/";
+    EntryMap old;
+    old.swap(dirs[relativeDir].entries);
+    dirs[relativeDir].entries = entries;
+
+    QStringList removed, added;
+    QList<PollingChanges::Change> modified;
+    for (auto it = old.constBegin(); it != old.constEnd(); ++it) {
+        auto entry = entries.constFind(it.key());
+        if (entry == entries.constEnd()) {
+            removed << it.key();
+        } else if (!entry->isDir && (entry->size != it->size || entry->modified != it->modified || entry->inode != it->inode)) {
+            modified << PollingChanges::Change { WatcherEvent::Modify, prefix + it.key(), QString() };
+        }
+    }
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        if (!old.contains(it.key()))
+            added << it.key();
+    }
+
+    // Same inode under a new name is a rename
+    QHash<quint64, QString> removedByInode;
+    for (auto &name : removed) {
+        if (old[name].inode)
+            removedByInode.insert(old[name].inode, name);
+    }
+    for (auto it = added.begin(); !removedByInode.isEmpty() && it != added.end();) {
+        const EntryStamp &entry = entries[*it];
+        auto from = removedByInode.find(entry.inode);
+        if (from == removedByInode.end() || old[from.value()].isDir != entry.isDir) {
+            ++it;
+            continue;
+        }
+        // Tracked subdirectories keep their listings, only their paths change
+        if (recursive && entry.isDir && !entry.isLink)
+            retrack(prefix + from.value(), prefix + *it);
+        out.changes << PollingChanges::Change { WatcherEvent::MovedFrom, prefix + from.value(), prefix + *it };
+        removed.removeOne(from.value());
+        removedByInode.erase(from);
+        it = added.erase(it);
+    }
+
+    for (auto &name : removed) {
+        if (recursive && old[name].isDir)
+            untrack(prefix + name);
+        out.changes << PollingChanges::Change { WatcherEvent::Delete, prefix + name, QString() };
+    }
+    for (auto &name : added) {
+        const EntryStamp &entry = entries[name];
+        // Might already have content by now; that is listed without reporting it
+        if (recursive && entry.isDir && !entry.isLink)
+            track(prefix + name, true);
+        out.changes << PollingChanges::Change { WatcherEvent::Create, prefix + name, QString() };
+    }
+    out.changes << modified;
+}
+
+// Takes the listing changes are compared against
+bool PollingWorker::track(const QString &relativeDir, bool withSubdirs) {
+    if (dirs.contains(relativeDir))
+        return false;
+    QString path = fullPath(relativeDir);
+    DirState state;
+    state.recheck = false;
+    if (!statDirectory(path, state.modified, state.changed) || !listDirectory(path, state.entries))
+        return false;
+    dirs.insert(relativeDir, state);
+    if (withSubdirs) {
+        QString prefix = relativeDir + "/";
+        for (auto it = state.entries.constBegin(); it != state.entries.constEnd(); ++it) {
+            if (it->isDir && !it->isLink)
+                track(prefix + it.key(), true);
+        }
+    }
+    return true;
+}
+
+void PollingWorker::untrack(const QString &relativeDir) {
+    QString prefix = relativeDir + "/";
+    for (auto it = dirs.begin(); it != dirs.end();) {
+        if (it.key() == relativeDir || it.key().startsWith(prefix))
+            it = dirs.erase(it);
+        else
+            ++it;
+    }
+}
+
+void PollingWorker::retrack(const QString &from, const QString &to) {
+    QString prefix = from + "/";
+    QStringList moved;
+    for (auto it = dirs.constBegin(); it != dirs.constEnd(); ++it) {
+        if (it.key() == from || it.key().startsWith(prefix))
+            moved << it.key();
+    }
+    for (auto &oldPath : moved)
+        dirs.insert(to + oldPath.mid(from.length()), dirs.take(oldPath));
+}
+
+QString PollingWorker::fullPath(const QString &relativeDir) const {
+    return relativeDir.isEmpty() ? root : root + "/" + relativeDir;
+}
+
+bool PollingWorker::statDirectory(const QString &path, qint64 &modified, qint64 &changed) {
+    struct stat st;
+    if (stat(path.toUtf8().constData(), &st) != 0 || !S_ISDIR(st.st_mode))
+        return false;
+    modified = toNsecs(st.st_mtim);
+    changed = toNsecs(st.st_ctim);
+    return true;
+}
+
+bool PollingWorker::listDirectory(const QString &path, EntryMap &entries) {
+    DIR *dir = opendir(path.toUtf8().constData());
+    if (!dir) {
+        qDebug() << TAG << path << strerror(errno);
+        return false;
+    }
+    int fd = dirfd(dir);
+    while (struct dirent *dent = readdir(dir)) {
+        const char *name = dent->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+            continue;
+        // symlinks are reported by what they point to, but never followed into
+        bool isLink = dent->d_type == DT_LNK;
+        struct stat st;
+        if (dent->d_type == DT_UNKNOWN) {
+            if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+            isLink = S_ISLNK(st.st_mode);
+        }
+        if ((isLink || dent->d_type != DT_UNKNOWN) && fstatat(fd, name, &st, 0) != 0)
+            continue;
+        EntryStamp entry;
+        entry.inode = dent->d_ino;
+        entry.size = st.st_size;
+        entry.modified = toNsecs(st.st_mtim);
+        entry.isDir = S_ISDIR(st.st_mode);
+        entry.isLink = isLink;
+        entries.insert(QString::fromUtf8(name), entry);
+    }
+    closedir(dir);
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+
+#include "../watcherworker.h"
+#include "../watcherevent.h"
+
+// Changes found by one poll; names are relative to root
+struct PollingChanges {
+    struct Change {
+        WatcherEvent::Type type;
+        QString name;
+        // renames only
+        QString newName;
+    };
+    QString root;
+    QList<Change> changes;
+};
+
+class PollingWorker : public WatcherWorker
+{
+    Q_OBJECT
+public:
+    PollingWorker();
+
+    // Both can be called from any thread, they take effect before the next poll.
+    // setRoot() always starts over from a fresh listing.
+    void setRoot(const QString &path, bool recursive);
+    // relative to root
+    void addSubdirectories(const QStringList &relativeDirs);
+
+    virtual void run() override;
+
+signals:
+    void changesFound(PollingChanges *changes);
+
+private:
+    struct EntryStamp {
+        quint64 inode;
+        qint64 size, modified;
+        bool isDir, isLink;
+    };
+    typedef QHash<QString, EntryStamp> EntryMap;
+
+    struct DirState {
+        // of the directory itself
+        qint64 modified, changed;
+        // list it again on the next poll, the stamp may be too coarse to show
+        // changes made right after the last listing
+        bool recheck;
+        EntryMap entries;
+    };
+
+    static bool statDirectory(const QString &path, qint64 &modified, qint64 &changed);
+    static bool listDirectory(const QString &path, EntryMap &entries);
+
+    bool hasRequests();
+    void applyRequests();
+    void sleep(int ms);
+    void poll(PollingChanges &out, bool fullScan);
+    void diff(const QString &relativeDir, EntryMap &entries, PollingChanges &out);
+    bool track(const QString &relativeDir, bool withSubdirs);
+    void untrack(const QString &relativeDir);
+    void retrack(const QString &from, const QString &to);
+    QString fullPath(const QString &relativeDir) const;
+
+    QMutex mutex;
+    QString requestedRoot;
+    bool requestedRecursive, rootRequested;
+    QStringList requestedSubdirs;
+
+    QString root;
+    bool recursive;
+    // relative directory ("" for the root) -> its last listing
+    QHash<QString, DirState> dirs;
+    int interval;
+};
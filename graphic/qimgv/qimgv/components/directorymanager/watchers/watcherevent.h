@@ -8,7 +8,9 @@ public:
         None,
         MovedFrom,
         MovedTo,
-        Modify
+        Modify,
+        Create,
+        Delete
     };
 
     WatcherEvent(const QString &name,int timerId, Type type = None);
@@ -4,7 +4,8 @@ DirectoryModel::DirectoryModel(QObject *parent) :
     QObject(parent),
     fileListSource(SOURCE_DIRECTORY)
 {
-    scaler = new Scaler(&cache);
+    scaler = new Scaler();
+    dirManager.setAsyncLoading(true);
 
     connect(&dirManager, &DirectoryManager::fileRemoved,  this, &DirectoryModel::onFileRemoved);
     connect(&dirManager, &DirectoryManager::fileAdded,    this, &DirectoryModel::onFileAdded);
@@ -14,6 +15,9 @@ DirectoryModel::DirectoryModel(QObject *parent) :
     connect(&dirManager, &DirectoryManager::dirAdded,    this, &DirectoryModel::dirAdded);
     connect(&dirManager, &DirectoryManager::dirRenamed,  this, &DirectoryModel::dirRenamed);
 
+    connect(&dirManager, &DirectoryManager::loadStarted, this, &DirectoryModel::loadStarted);
+    connect(&dirManager, &DirectoryManager::entriesInserted, this, &DirectoryModel::entriesInserted);
+    connect(&dirManager, &DirectoryManager::entriesRemoved, this, &DirectoryModel::onEntriesRemoved);
     connect(&dirManager, &DirectoryManager::loaded, this, &DirectoryModel::loaded);
     connect(&dirManager, &DirectoryManager::sortingChanged, this, &DirectoryModel::onSortingChanged);
     connect(&loader, &Loader::loadFinished, this, &DirectoryModel::onImageReady);
@@ -93,6 +97,10 @@ bool DirectoryModel::isEmpty() const {
     return dirManager.isEmpty();
 }
 
+bool DirectoryModel::isLoading() const {
+    return dirManager.isLoading();
+}
+
 QString DirectoryModel::firstFile() const {
     return dirManager.firstFile();
 }
@@ -115,6 +123,10 @@ QDateTime DirectoryModel::lastModified(QString filePath) const {
 
 // -----------------------------------------------------------------------------
 
+bool DirectoryModel::insert(QString filePath) {
+    return dirManager.insertFileEntry(filePath);
+}
+
 bool DirectoryModel::forceInsert(QString filePath) {
     return dirManager.forceInsertFileEntry(filePath);
 }
@@ -240,7 +252,8 @@ bool DirectoryModel::saveFile(const QString &filePath, const QString &destPath)
 
 // dirManager events
 
-void DirectoryModel::onSortingChanged() {
+void DirectoryModel::onSortingChanged(QList<int> dirOrder, QList<int> fileOrder) {
+    emit entriesReordered(dirOrder, fileOrder);
     emit sortingChanged(sortingMode());
 }
 
@@ -266,6 +279,12 @@ void DirectoryModel::onFileRemoved(QString filePath, int index) {
     emit fileRemoved(filePath, index);
 }
 
+void DirectoryModel::onEntriesRemoved(QList<int> dirIndices, QList<int> fileIndices, QStringList filePaths) {
+    for(auto &filePath : filePaths)
+        unload(filePath);
+    emit entriesRemoved(dirIndices, fileIndices, filePaths);
+}
+
 void DirectoryModel::onFileRenamed(QString fromPath, int indexFrom, QString toPath, int indexTo) {
     unload(fromPath);
     emit fileRenamed(fromPath, indexFrom, toPath, indexTo);
@@ -25,12 +25,14 @@ public:
     QString fileNameAt(int index) const;
     bool containsFile(QString filePath) const;
     bool isEmpty() const;
+    bool isLoading() const;
     QString nextOf(QString filePath) const;
     QString prevOf(QString filePath) const;
     QString firstFile() const;
     QString lastFile() const;
     QDateTime lastModified(QString filePath) const;
 
+    bool insert(QString filePath);
     bool forceInsert(QString filePath);
     void copyFileTo(const QString &srcFile, const QString &destDirPath, bool force, FileOpResult &result);
     void moveFileTo(const QString &srcFile, const QString &destDirPath, bool force, FileOpResult &result);
@@ -80,6 +82,11 @@ signals:
     void dirRemoved(QString dirPath, int index);
     void dirRenamed(QString dirPath, int indexFrom, QString toPath, int indexTo);
     void dirAdded(QString dirPath);
+    void loadStarted(QString filePath);
+    void entriesInserted(QList<int> dirIndices, QList<int> fileIndices);
+    void entriesRemoved(QList<int> dirIndices, QList<int> fileIndices, QStringList filePaths);
+    // order[newIndex] == oldIndex; sent right before sortingChanged()
+    void entriesReordered(QList<int> dirOrder, QList<int> fileOrder);
     void loaded(QString filePath);
     void loadFailed(const QString &path);
     void sortingChanged(SortingMode);
@@ -95,9 +102,10 @@ private:
 
 private slots:
     void onImageReady(std::shared_ptr<Image> img, const QString &path);
-    void onSortingChanged();
+    void onSortingChanged(QList<int> dirOrder, QList<int> fileOrder);
     void onFileAdded(QString filePath);
     void onFileRemoved(QString filePath, int index);
+    void onEntriesRemoved(QList<int> dirIndices, QList<int> fileIndices, QStringList filePaths);
     void onFileRenamed(QString fromPath, int indexFrom, QString toPath, int indexTo);
     void onFileModified(QString filePath);
 };
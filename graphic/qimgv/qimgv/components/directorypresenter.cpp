@@ -12,6 +12,9 @@ void DirectoryPresenter::unsetModel() {
     disconnect(model.get(), &DirectoryModel::dirRemoved,   this, &DirectoryPresenter::onDirRemoved);
     disconnect(model.get(), &DirectoryModel::dirAdded,     this, &DirectoryPresenter::onDirAdded);
     disconnect(model.get(), &DirectoryModel::dirRenamed,   this, &DirectoryPresenter::onDirRenamed);
+    disconnect(model.get(), &DirectoryModel::entriesInserted, this, &DirectoryPresenter::onEntriesInserted);
+    disconnect(model.get(), &DirectoryModel::entriesRemoved, this, &DirectoryPresenter::onEntriesRemoved);
+    disconnect(model.get(), &DirectoryModel::entriesReordered, this, &DirectoryPresenter::onEntriesReordered);
     model = nullptr;
     // also empty view?
 }
@@ -24,8 +27,8 @@ void DirectoryPresenter::setView(std::shared_ptr<IDirectoryView> _view) {
         view->populate(mShowDirs ? model->totalCount() : model->fileCount());
     connect(dynamic_cast<QObject *>(view.get()), SIGNAL(itemActivated(int)),
             this, SLOT(onItemActivated(int)));
-    connect(dynamic_cast<QObject *>(view.get()), SIGNAL(thumbnailsRequested(QList<int>, int, bool, bool)),
-            this, SLOT(generateThumbnails(QList<int>, int, bool, bool)));
+    connect(dynamic_cast<QObject *>(view.get()), SIGNAL(thumbnailsRequested(QList<int>, int, bool, bool, bool)),
+            this, SLOT(generateThumbnails(QList<int>, int, bool, bool, bool)));
     connect(dynamic_cast<QObject *>(view.get()), SIGNAL(draggedOut()),
             this, SLOT(onDraggedOut()));
     connect(dynamic_cast<QObject *>(view.get()), SIGNAL(draggedOver(int)),
@@ -50,6 +53,9 @@ void DirectoryPresenter::setModel(std::shared_ptr<DirectoryModel> newModel) {
     connect(model.get(), &DirectoryModel::dirRemoved,   this, &DirectoryPresenter::onDirRemoved);
     connect(model.get(), &DirectoryModel::dirAdded,     this, &DirectoryPresenter::onDirAdded);
     connect(model.get(), &DirectoryModel::dirRenamed,   this, &DirectoryPresenter::onDirRenamed);
+    connect(model.get(), &DirectoryModel::entriesInserted, this, &DirectoryPresenter::onEntriesInserted);
+    connect(model.get(), &DirectoryModel::entriesRemoved, this, &DirectoryPresenter::onEntriesRemoved);
+    connect(model.get(), &DirectoryModel::entriesReordered, this, &DirectoryPresenter::onEntriesReordered);
 }
 
 void DirectoryPresenter::reloadModel() {
@@ -94,7 +100,9 @@ void DirectoryPresenter::onFileRenamed(QString fromPath, int indexFrom, QString
             view->select(indexTo);
             view->focusOn(indexTo);
         } else if(oldSelection.count() > 1) {
-            view->select(view->selection() << indexTo);
+            auto newSelection = view->selection();
+            newSelection.add(indexTo);
+            view->select(newSelection);
         }
     }
 }
@@ -134,7 +142,9 @@ void DirectoryPresenter::onDirRenamed(QString fromPath, int indexFrom, QString t
             view->select(indexTo);
             view->focusOn(indexTo);
         } else if(oldSelection.count() > 1) {
-            view->select(view->selection() << indexTo);
+            auto newSelection = view->selection();
+            newSelection.add(indexTo);
+            view->select(newSelection);
         }
     }
 }
@@ -146,6 +156,54 @@ void DirectoryPresenter::onDirAdded(QString dirPath) {
     view->insertItem(index);
 }
 
+// new batch from a directory that is still being listed,
+// or a burst of files created while watching it
+void DirectoryPresenter::onEntriesInserted(QList<int> dirIndices, QList<int> fileIndices) {
+    if(!view)
+        return;
+    if(!mShowDirs) {
+        view->insertItems(fileIndices);
+        return;
+    }
+    QList<int> indices = dirIndices;
+    for(auto i : fileIndices)
+        indices << model->dirCount() + i;
+    view->insertItems(indices);
+}
+
+void DirectoryPresenter::onEntriesRemoved(QList<int> dirIndices, QList<int> fileIndices) {
+    if(!view)
+        return;
+    if(!mShowDirs) {
+        view->removeItems(fileIndices);
+        return;
+    }
+    // file positions are relative to the dir count before the removal
+    int oldDirCount = model->dirCount() + dirIndices.count();
+    QList<int> indices = dirIndices;
+    for(auto i : fileIndices)
+        indices << oldDirCount + i;
+    view->removeItems(indices);
+}
+
+// re-sort; the view moves its items & thumbnails instead of repopulating
+void DirectoryPresenter::onEntriesReordered(QList<int> dirOrder, QList<int> fileOrder) {
+    if(!view)
+        return;
+    if(!mShowDirs) {
+        view->reorderItems(fileOrder);
+    } else {
+        // dirs go first, files keep their offset
+        int dirCount = dirOrder.count();
+        QList<int> order = dirOrder;
+        order.reserve(dirCount + fileOrder.count());
+        for(auto i : fileOrder)
+            order << dirCount + i;
+        view->reorderItems(order);
+    }
+    view->focusOnSelection();
+}
+
 bool DirectoryPresenter::showDirs() {
     return mShowDirs;
 }
@@ -157,32 +215,36 @@ void DirectoryPresenter::setShowDirs(bool mode) {
     populateView();
 }
 
+// ascending, except the last selected one which goes at the end
 QList<QString> DirectoryPresenter::selectedPaths() const {
     QList<QString> paths;
     if(!view)
         return paths;
-    if(mShowDirs) {
-        for(auto i : view->selection()) {
-            if(i < model->dirCount())
-                paths << model->dirPathAt(i);
-            else
-                paths << model->filePathAt(i - model->dirCount());
-        }
-    } else {
-        for(auto i : view->selection()) {
-            paths << model->filePathAt(i);
-        }
+    const ItemSelection &selection = view->selection();
+    int dirCount = mShowDirs ? model->dirCount() : 0;
+    auto pathAt = [&](int i) {
+        return (i < dirCount) ? model->dirPathAt(i) : model->filePathAt(i - dirCount);
+    };
+    paths.reserve(selection.count());
+    for(auto i : selection) {
+        if(i != selection.last())
+            paths << pathAt(i);
     }
+    if(!selection.isEmpty())
+        paths << pathAt(selection.last());
     return paths;
 }
 
-void DirectoryPresenter::generateThumbnails(QList<int> indexes, int size, bool crop, bool force) {
+void DirectoryPresenter::generateThumbnails(QList<int> indexes, int size, bool crop, bool force, bool cacheOnly) {
     if(!view || !model)
         return;
     thumbnailer.clearTasks();
     if(!mShowDirs) {
-        for(int i : indexes)
-            thumbnailer.getThumbnailAsync(model->filePathAt(i), size, crop, force);
+        for(int i : indexes) {
+            QString path = model->filePathAt(i);
+            view->setPlaceholder(i, thumbnailer.placeholder(path));
+            thumbnailer.getThumbnailAsync(path, size, crop, force, cacheOnly);
+        }
         return;
     }
     for(int i : indexes) {
@@ -210,7 +272,8 @@ void DirectoryPresenter::generateThumbnails(QList<int> indexes, int size, bool c
             view->setThumbnail(i, thumb);
         } else {
             QString path = model->filePathAt(i - model->dirCount());
-            thumbnailer.getThumbnailAsync(path, size, crop, force);
+            view->setPlaceholder(i, thumbnailer.placeholder(path));
+            thumbnailer.getThumbnailAsync(path, size, crop, force, cacheOnly);
         }
     }
 }
@@ -31,6 +31,9 @@ public:
     void onDirRemoved(QString dirPath, int index);
     void onDirRenamed(QString fromPath, int indexFrom, QString toPath, int indexTo);
     void onDirAdded(QString dirPath);
+    void onEntriesInserted(QList<int> dirIndices, QList<int> fileIndices);
+    void onEntriesRemoved(QList<int> dirIndices, QList<int> fileIndices);
+    void onEntriesReordered(QList<int> dirOrder, QList<int> fileOrder);
 
     bool showDirs();
     void setShowDirs(bool mode);
@@ -49,7 +52,7 @@ public slots:
     void reloadModel();
 
 private slots:
-    void generateThumbnails(QList<int>, int, bool, bool);
+    void generateThumbnails(QList<int>, int, bool, bool, bool);
     void onThumbnailReady(std::shared_ptr<Thumbnail> thumb, QString filePath);
     void populateView();
     void onItemActivated(int absoluteIndex);
@@ -2,41 +2,27 @@
 
 #include <QObject>
 #include <QThreadPool>
-#include <QThread>
-#include <QMutex>
-#include "components/cache/cache.h"
 #include "scalerrequest.h"
 #include "scalerrunnable.h"
+#include "utils/latestmailbox.h"
 
 class Scaler : public QObject {
     Q_OBJECT
 public:
-    explicit Scaler(Cache *_cache, QObject *parent = nullptr);
+    explicit Scaler(QObject *parent = nullptr);
+    ~Scaler();
 
 signals:
     void scalingFinished(QPixmap* result, ScalerRequest request);
-    void acceptScalingResult(QImage *image, ScalerRequest req);
-    void startBufferedRequest();
 
 public slots:
     void requestScaled(ScalerRequest req);
 
 private slots:
-    void onTaskStart(ScalerRequest req);
-    void onTaskFinish(QImage* scaled, ScalerRequest req);
-    void slotStartBufferedRequest();
-    void slotForwardScaledResult(QImage *image, ScalerRequest req);
+    void onTaskFinish(QImage* scaled, ScalerRequest req, quint64 generation);
 
 private:
     QThreadPool *pool;
     ScalerRunnable *runnable;
-    bool buffered, running;
-    clock_t currentRequestTimestamp;
-    ScalerRequest bufferedRequest, startedRequest;
-
-    Cache *cache;
-
-    void startRequest(ScalerRequest req);
-
-    QSemaphore *sem;
+    LatestMailbox<ScalerRequest> mailbox;
 };
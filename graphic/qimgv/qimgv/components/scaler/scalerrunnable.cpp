@@ -2,15 +2,26 @@
 
 #include <QElapsedTimer>
 
-ScalerRunnable::ScalerRunnable() {
+ScalerRunnable::ScalerRunnable(LatestMailbox<ScalerRequest> *_mailbox) : mailbox(_mailbox) {
 }
 
-void ScalerRunnable::setRequest(ScalerRequest r) {
-    req = r;
+void ScalerRunnable::run() {
+    ScalerRequest req;
+    quint64 generation;
+    do {
+        while(mailbox->take(req, generation)) {
+            QImage *scaled = scale(req);
+            if(mailbox->isCurrent(generation))
+                emit finished(scaled, req, generation);
+            else
+                delete scaled;
+            // don't hold on to the source image while idle
+            req = ScalerRequest();
+        }
+    } while(mailbox->finish());
 }
 
-void ScalerRunnable::run() {
-    emit started(req);
+QImage *ScalerRunnable::scale(const ScalerRequest &req) {
     //QElapsedTimer t;
     //t.start();
     QImage *scaled = nullptr;
@@ -20,5 +31,5 @@ void ScalerRunnable::run() {
         scaled = ImageLib::scaled(req.image->getImage(), req.size, req.filter);
     }
     //qDebug() << ">> " << req.size << ": " << t.elapsed();
-    emit finished(scaled, req);
+    return scaled;
 }
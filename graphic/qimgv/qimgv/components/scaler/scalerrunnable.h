@@ -4,23 +4,22 @@
 #include <QRunnable>
 #include <QThread>
 #include <QDebug>
-#include "components/cache/cache.h"
 #include "scalerrequest.h"
 #include "utils/imagelib.h"
+#include "utils/latestmailbox.h"
 #include "settings.h"
 
 class ScalerRunnable : public QObject, public QRunnable
 {
     Q_OBJECT
 public:
-    explicit ScalerRunnable();
-    void setRequest(ScalerRequest r);
+    explicit ScalerRunnable(LatestMailbox<ScalerRequest> *_mailbox);
     void run();
 signals:
-    void started(ScalerRequest);
-    void finished(QImage*, ScalerRequest);
+    void finished(QImage*, ScalerRequest, quint64);
 
 private:
-    ScalerRequest req;
+    LatestMailbox<ScalerRequest> *mailbox;
+    QImage *scale(const ScalerRequest &req);
     const float CMPL_FALLBACK_THRESHOLD = 70.0; // equivalent of ~ 5000x3500 @ 32bpp
 };
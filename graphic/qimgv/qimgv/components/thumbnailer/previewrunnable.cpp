@@ -0,0 +1,13 @@
+#include "previewrunnable.h"
+
+PreviewRunnable::PreviewRunnable(QString _path) : path(_path) {
+}
+
+void PreviewRunnable::run() {
+    DocumentInfo info(path);
+    std::unique_ptr<QImage> preview(new QImage(info.embeddedPreview()));
+    if(preview->isNull())
+        return;
+    preview = ImageLib::exifRotated(std::move(preview), info.exifOrientation());
+    emit finished(*preview, path);
+}
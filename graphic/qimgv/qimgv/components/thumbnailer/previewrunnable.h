@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QImage>
+#include "sourcecontainers/documentinfo.h"
+#include "utils/imagelib.h"
+
+// reads the embedded exif preview of an image, already rotated
+class PreviewRunnable : public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    PreviewRunnable(QString _path);
+    void run();
+private:
+    QString path;
+signals:
+    void finished(QImage, QString);
+};
@@ -1,5 +1,16 @@
 #include "thumbnailer.h"
 
+namespace {
+    // so that placeholder() never waits for the file
+    class PlaceholderLoader : public QRunnable {
+    public:
+        explicit PlaceholderLoader(ThumbnailCache *_cache) : cache(_cache) {}
+        void run() override { cache->preloadPlaceholders(); }
+    private:
+        ThumbnailCache *cache;
+    };
+}
+
 Thumbnailer::Thumbnailer() {
     cache = new ThumbnailCache();
     pool = new QThreadPool(this);
@@ -8,6 +19,8 @@ Thumbnailer::Thumbnailer() {
     if(threads > globalThreads)
         threads = globalThreads;
     pool->setMaxThreadCount(threads);
+    if(settings->useThumbnailCache())
+        pool->start(new PlaceholderLoader(cache));
 }
 
 Thumbnailer::~Thumbnailer() {
@@ -27,15 +40,54 @@ std::shared_ptr<Thumbnail> Thumbnailer::getThumbnail(QString filePath, int size)
     return ThumbnailerRunnable::generate(nullptr, filePath, size, false, false);
 }
 
-void Thumbnailer::getThumbnailAsync(QString path, int size, bool crop, bool force) {
+QImage Thumbnailer::placeholder(QString path) {
+    if(!settings->useThumbnailCache())
+        return QImage();
+    return cache->readPlaceholder(path);
+}
+
+QImage Thumbnailer::cachedPreview(QString path) {
+    if(!settings->useThumbnailCache())
+        return QImage();
+    // the sizes the views ask for, largest first; cropped ones are no use here
+    QList<int> sizes;
+    sizes << static_cast<int>(qApp->devicePixelRatio() * settings->folderViewIconSize());
+    if(!settings->squareThumbnails()) {
+        int panelSize = static_cast<int>(qApp->devicePixelRatio() * qBound(20, settings->panelPreviewsSize(), 300));
+        sizes.insert(panelSize > sizes.first() ? 0 : 1, panelSize);
+    }
+    QString time = QString::number(QFileInfo(path).lastModified().toMSecsSinceEpoch());
+    for(int size : sizes) {
+        std::unique_ptr<QImage> image(cache->readThumbnail(ThumbnailerRunnable::generateIdString(path, size, false)));
+        if(image && image->text("lastModified") == time)
+            return *image;
+    }
+    return QImage();
+}
+
+void Thumbnailer::getPreviewAsync(QString path) {
+    auto runnable = new PreviewRunnable(path);
+    connect(runnable, &PreviewRunnable::finished, this, &Thumbnailer::previewReady);
+    runnable->setAutoDelete(true);
+    pool->start(runnable);
+}
+
+void Thumbnailer::getThumbnailAsync(QString path, int size, bool crop, bool force, bool cacheOnly) {
+    if(cacheOnly && !settings->useThumbnailCache())
+        return;
     if(!runningTasks.contains(path, size))
-        startThumbnailerThread(path, size, crop, force);
+        startThumbnailerThread(path, size, crop, force, cacheOnly);
 }
 
-void Thumbnailer::startThumbnailerThread(QString filePath, int size, bool crop, bool force) {
-    auto runnable = new ThumbnailerRunnable(settings->useThumbnailCache() ? cache : nullptr, filePath, size, crop, force);
-    connect(runnable, &ThumbnailerRunnable::taskStart, this, &Thumbnailer::onTaskStart);
-    connect(runnable, &ThumbnailerRunnable::taskEnd, this, &Thumbnailer::onTaskEnd);
+void Thumbnailer::startThumbnailerThread(QString filePath, int size, bool crop, bool force, bool cacheOnly) {
+    auto runnable = new ThumbnailerRunnable(settings->useThumbnailCache() ? cache : nullptr, filePath, size, crop, force, cacheOnly);
+    // cache-only tasks are cheap and must not hold back a real one for the same file
+    if(cacheOnly) {
+        connect(runnable, &ThumbnailerRunnable::taskEnd, this, &Thumbnailer::onCacheTaskEnd);
+    } else {
+        connect(runnable, &ThumbnailerRunnable::taskStart, this, &Thumbnailer::onTaskStart);
+        connect(runnable, &ThumbnailerRunnable::taskEnd, this, &Thumbnailer::onTaskEnd);
+    }
     runnable->setAutoDelete(true);
     pool->start(runnable);
 }
@@ -48,3 +100,9 @@ void Thumbnailer::onTaskEnd(std::shared_ptr<Thumbnail> thumbnail, QString filePa
     runningTasks.remove(filePath, thumbnail->size());
     emit thumbnailReady(thumbnail, filePath);
 }
+
+// nullptr if the cache had nothing
+void Thumbnailer::onCacheTaskEnd(std::shared_ptr<Thumbnail> thumbnail, QString filePath) {
+    if(thumbnail)
+        emit thumbnailReady(thumbnail, filePath);
+}
@@ -2,6 +2,7 @@
 
 #include <QThreadPool>
 #include "components/thumbnailer/thumbnailerrunnable.h"
+#include "components/thumbnailer/previewrunnable.h"
 #include "components/cache/thumbnailcache.h"
 #include "settings.h"
 
@@ -12,22 +13,32 @@ public:
     explicit Thumbnailer();
     ~Thumbnailer();
     static std::shared_ptr<Thumbnail> getThumbnail(QString filePath, int size);
+    // tiny preview to show while the thumbnail loads; null if there is none
+    QImage placeholder(QString path);
+    // cached thumbnail to show in place of the image without touching the
+    // file; null if none. Carries "originalWidth" / "originalHeight" texts
+    QImage cachedPreview(QString path);
+    // embedded exif preview, read in the pool; comes via previewReady()
+    void getPreviewAsync(QString path);
     void clearTasks();
     void waitForDone();
 
 public slots:
-    void getThumbnailAsync(QString path, int size, bool crop, bool force);
+    // cacheOnly: only what the disk cache has, nothing is generated
+    void getThumbnailAsync(QString path, int size, bool crop, bool force, bool cacheOnly = false);
 
 private:
     ThumbnailCache *cache;
     QThreadPool *pool;
-    void startThumbnailerThread(QString filePath, int size, bool crop, bool force);
+    void startThumbnailerThread(QString filePath, int size, bool crop, bool force, bool cacheOnly);
     QMultiMap<QString, int> runningTasks;
 
 private slots:
     void onTaskStart(QString filePath, int size);
     void onTaskEnd(std::shared_ptr<Thumbnail> thumbnail, QString filePath);
+    void onCacheTaskEnd(std::shared_ptr<Thumbnail> thumbnail, QString filePath);
 
 signals:
     void thumbnailReady(std::shared_ptr<Thumbnail> thumbnail, QString filePath);
+    void previewReady(QImage preview, QString filePath);
 };
@@ -1,17 +1,18 @@
 #include "thumbnailerrunnable.h"
 
-ThumbnailerRunnable::ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force) :
+ThumbnailerRunnable::ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force, bool _cacheOnly) :
     path(_path),
     size(_size),
     crop(_crop),
     force(_force),
+    cacheOnly(_cacheOnly),
     cache(_cache)
 {
 }
 
 void ThumbnailerRunnable::run() {
     emit taskStart(path, size);
-    std::shared_ptr<Thumbnail> thumbnail = generate(cache, path, size, crop, force);
+    std::shared_ptr<Thumbnail> thumbnail = generate(cache, path, size, crop, force, cacheOnly);
     emit taskEnd(thumbnail, path);
 }
 
@@ -23,20 +24,33 @@ QString ThumbnailerRunnable::generateIdString(QString path, int size, bool crop)
     return queryStr;
 }
 
-std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache, QString path, int size, bool crop, bool force) {
-    DocumentInfo imgInfo(path);
+// size after ImageLib::exifRotated()
+QSize ThumbnailerRunnable::orientedSize(QSize size, int orientation) {
+    if(orientation >= 4 && orientation <= 7)
+        size.transpose();
+    return size;
+}
+
+std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache, QString path, int size, bool crop, bool force, bool cacheOnly) {
+    // cache hits only need the mtime; DocumentInfo reads the file to detect its format
+    QFileInfo fileInfo(path);
     QString thumbnailId = generateIdString(path, size, crop);
     std::unique_ptr<QImage> image;
 
-    QString time = QString::number(imgInfo.lastModified().toMSecsSinceEpoch());
+    QString time = QString::number(fileInfo.lastModified().toMSecsSinceEpoch());
 
     if(!force && cache) {
         image.reset(cache->readThumbnail(thumbnailId));
         if(image && image->text("lastModified") != time)
             image.reset(nullptr);
     }
+    if(!image && cacheOnly)
+        return nullptr;
 
-    if(!image) {
+    bool generated = !image;
+    int orientation = 0;
+    if(generated) {
+        DocumentInfo imgInfo(path);
         if(imgInfo.type() == DocumentType::NONE) {
             std::shared_ptr<Thumbnail> thumbnail(new Thumbnail(imgInfo.fileName(), "", size, nullptr));
             return thumbnail;
@@ -49,7 +63,8 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
         image.reset(pair.first);
         QSize originalSize = pair.second;
 
-        image = ImageLib::exifRotated(std::move(image), imgInfo.exifOrientation());
+        orientation = imgInfo.exifOrientation();
+        image = ImageLib::exifRotated(std::move(image), orientation);
 
         // put in image info
         image->setText("originalWidth", QString::number(originalSize.width()));
@@ -68,6 +83,17 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
                 cache->saveThumbnail(image.get(), thumbnailId);
         }
     }
+    // also fills in placeholders for thumbnails cached before they existed
+    if(cache && !image->isNull() && (generated || !cache->hasPlaceholder(path))) {
+        // the size is stored as it was before exif rotation
+        QSize originalSize(image->text("originalWidth").toInt(), image->text("originalHeight").toInt());
+        if(crop) {
+            if(!generated)
+                orientation = DocumentInfo(path).exifOrientation();
+            originalSize = orientedSize(originalSize, orientation);
+        }
+        cache->savePlaceholder(path, *image, originalSize);
+    }
     auto && tmpPixmap = new QPixmap(image->size());
     *tmpPixmap = QPixmap::fromImage(*image);
     tmpPixmap->setDevicePixelRatio(qApp->devicePixelRatio());
@@ -83,7 +109,7 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
                 image->text("label");
     }
     std::shared_ptr<QPixmap> pixmapPtr(tmpPixmap);
-    std::shared_ptr<Thumbnail> thumbnail(new Thumbnail(imgInfo.fileName(), label, size, pixmapPtr));
+    std::shared_ptr<Thumbnail> thumbnail(new Thumbnail(fileInfo.fileName(), label, size, pixmapPtr));
     return thumbnail;
 }
 
@@ -16,17 +16,20 @@
 class ThumbnailerRunnable : public QObject, public QRunnable {
     Q_OBJECT
 public:
-    ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force);
+    ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force, bool _cacheOnly = false);
     ~ThumbnailerRunnable();
     void run();
-    static std::shared_ptr<Thumbnail> generate(ThumbnailCache *cache, QString path, int size, bool crop, bool force);
-private:
+    // cacheOnly: returns nullptr instead of generating if the cache has nothing
+    static std::shared_ptr<Thumbnail> generate(ThumbnailCache *cache, QString path, int size, bool crop, bool force, bool cacheOnly = false);
+    // cache id of a thumbnail
     static QString generateIdString(QString path, int size, bool crop);
+private:
     static std::pair<QImage*, QSize> createThumbnail(QString path, const char* format, int size, bool crop);
     static std::pair<QImage*, QSize> createVideoThumbnail(QString path, int size, bool crop);
+    static QSize orientedSize(QSize size, int orientation);
     QString path;
     int size;
-    bool crop, force;
+    bool crop, force, cacheOnly;
     ThumbnailCache* cache = nullptr;
 
 signals:
@@ -26,6 +26,8 @@ Core::Core()
     initActions();
     readSettings();
     slideshowTimer.setSingleShot(true);
+    skimTimer.setSingleShot(true);
+    skimTimer.setInterval(SKIM_PAUSE);
     connect(settings, &Settings::settingsChanged, this, &Core::readSettings);
 
     QVersionNumber lastVersion = settings->lastVersion();
@@ -123,6 +125,9 @@ void Core::connectComponents() {
     connect(model.get(), &DirectoryModel::fileRemoved,    this, &Core::onFileRemoved);
     connect(model.get(), &DirectoryModel::fileRenamed,    this, &Core::onFileRenamed);
     connect(model.get(), &DirectoryModel::fileModified,   this, &Core::onFileModified);
+    connect(model.get(), &DirectoryModel::loadStarted,    this, &Core::onModelLoadStarted);
+    connect(model.get(), &DirectoryModel::entriesInserted, this, &Core::onEntriesInserted);
+    connect(model.get(), &DirectoryModel::entriesRemoved, this, &Core::onEntriesRemoved);
     connect(model.get(), &DirectoryModel::loaded,         this, &Core::onModelLoaded);
     connect(model.get(), &DirectoryModel::imageReady,     this, &Core::onModelItemReady);
     connect(model.get(), &DirectoryModel::imageUpdated,   this, &Core::onModelItemUpdated);
@@ -130,6 +135,8 @@ void Core::connectComponents() {
     connect(model.get(), &DirectoryModel::loadFailed,     this, &Core::onLoadFailed);
 
     connect(&slideshowTimer, &QTimer::timeout, this, &Core::nextImageSlideshow);
+    connect(&skimTimer, &QTimer::timeout, this, &Core::onSkimPause);
+    connect(&thumbnailer, &Thumbnailer::previewReady, this, &Core::onPreviewReady);
 }
 
 void Core::initActions() {
@@ -318,13 +325,27 @@ void Core::syncRandomizer() {
     }
 }
 
-void Core::onModelLoaded() {
+void Core::onModelLoadStarted() {
     thumbPanelPresenter.reloadModel();
     folderViewPresenter.reloadModel();
+}
+
+// views are already filled in by now, see DirectoryPresenter::onEntriesInserted()
+void Core::onModelLoaded() {
     thumbPanelPresenter.selectAndFocus(state.currentFilePath);
-    folderViewPresenter.selectAndFocus(state.currentFilePath);
+    if(!state.pendingFocusPath.isEmpty())
+        folderViewPresenter.selectAndFocus(state.pendingFocusPath);
+    else
+        folderViewPresenter.selectAndFocus(state.currentFilePath);
+    state.pendingFocusPath = "";
+    if(state.pendingLoad != PENDING_NONE && model->fileCount()) {
+        int index = (state.pendingLoad == PENDING_LAST) ? model->fileCount() - 1 : 0;
+        loadFileIndex(index, false, true);
+    }
+    state.pendingLoad = PENDING_NONE;
     if(shuffle)
         syncRandomizer();
+    updateInfoString();
 }
 
 void Core::onDirectoryViewFileActivated(QString filePath) {
@@ -691,6 +712,23 @@ void Core::onFileRemoved(QString filePath, int index) {
     updateInfoString();
 }
 
+// a burst of deletes, applied as one batch
+void Core::onEntriesRemoved(QList<int> dirIndices, QList<int> fileIndices, QStringList filePaths) {
+    Q_UNUSED(dirIndices)
+    int pos = state.currentFilePath.isEmpty() ? -1 : filePaths.indexOf(state.currentFilePath);
+    if(pos != -1) {
+        // whatever came after the current file moved up by the number of files removed before it
+        onFileRemoved(state.currentFilePath, fileIndices.at(pos) - pos);
+        return;
+    }
+    if(model->isEmpty()) {
+        mw->closeImage();
+        state.hasActiveImage = false;
+        state.currentFilePath = "";
+    }
+    updateInfoString();
+}
+
 void Core::onFileRenamed(QString fromPath, int /*indexFrom*/, QString /*toPath*/, int indexTo) {
     if(state.currentFilePath == fromPath) {
         loadFileIndex(indexTo, true, settings->usePreloader());
@@ -705,6 +743,14 @@ void Core::onFileAdded(QString filePath) {
         loadFileIndex(0, false, settings->usePreloader());
 }
 
+void Core::onEntriesInserted(QList<int> dirIndices, QList<int> fileIndices) {
+    Q_UNUSED(dirIndices)
+    updateInfoString();
+    // first files showed up in a watched directory; loading is handled in onModelLoaded()
+    if(!model->isLoading() && fileIndices.count() && model->fileCount() == fileIndices.count() && state.currentFilePath == "")
+        loadFileIndex(0, false, settings->usePreloader());
+}
+
 // !! fixme
 void Core::onFileModified(QString filePath) {
     Q_UNUSED(filePath)
@@ -1183,7 +1229,8 @@ void Core::print() {
 
 void Core::scalingRequest(QSize size, ScalingFilter filter) {
     // filter out an unnecessary scale request at statup
-    if(mw->isVisible() && state.hasActiveImage) {
+    // a preview is not worth decoding the image for
+    if(mw->isVisible() && state.hasActiveImage && !state.showingPreview) {
         std::shared_ptr<Image> forScale = model->getImage(state.currentFilePath);
         if(forScale) {
             model->scaler->requestScaled(ScalerRequest(forScale, size, state.currentFilePath, filter));
@@ -1214,36 +1261,43 @@ bool Core::loadPath(QString path) {
         path.remove(0, 7);
 
     stopSlideshow();
-    state.delayModel = false;
+    state.pendingLoad = PENDING_NONE;
+    state.pendingFocusPath = "";
     QFileInfo fileInfo(path);
     if(fileInfo.isDir()) {
         state.directoryPath = QDir(path).absolutePath();
     } else if(fileInfo.isFile()) {
         state.directoryPath = fileInfo.absolutePath();
-        if(model->directoryPath() != state.directoryPath)
-            state.delayModel = true;
     } else {
         mw->showError(tr("Could not open path: ") + path);
         qDebug() << "Could not open path: " << path;
         return false;
     }
-    if(!state.delayModel && !setDirectory(state.directoryPath))
+    // this does not wait for the directory listing
+    if(!setDirectory(state.directoryPath))
         return false;
 
     // load file / folderview
     if(fileInfo.isFile()) {
-        int index = model->indexOfFile(fileInfo.absoluteFilePath());
-        // DirectoryManager only checks file extensions via regex (performance reasons)
-        // But in this case we force check mimetype
+        QString filePath = fileInfo.absoluteFilePath();
+        int index = model->indexOfFile(filePath);
+        // Not listed yet. Insert it now so we can show it right away,
+        // the listing will skip it when it gets there.
         if(index == -1) {
-            QStringList types = settings->supportedMimeTypes();
-            QMimeDatabase db;
-            QMimeType type = db.mimeTypeForFile(fileInfo.absoluteFilePath());
-            if(types.contains(type.name())) {
-                if(model->forceInsert(fileInfo.absoluteFilePath())) {
-                    index = model->indexOfFile(fileInfo.absoluteFilePath());
-                }
+            // don't let onFileAdded() pick it up as the first file
+            state.currentFilePath = filePath;
+            // DirectoryManager only checks file extensions (performance reasons)
+            // But in this case we force check mimetype
+            if(!model->insert(filePath)) {
+                QStringList types = settings->supportedMimeTypes();
+                QMimeDatabase db;
+                QMimeType type = db.mimeTypeForFile(filePath);
+                if(types.contains(type.name()))
+                    model->forceInsert(filePath);
             }
+            index = model->indexOfFile(filePath);
+            if(index == -1)
+                state.currentFilePath = "";
         }
         mw->enableDocumentView();
         return loadFileIndex(index, false, settings->usePreloader());
@@ -1271,6 +1325,7 @@ bool Core::loadFileIndex(int index, bool async, bool preload) {
     auto entry = model->fileEntryAt(index);
     if(entry.path.isEmpty())
         return false;
+    skimTimer.stop();
     state.currentFilePath = entry.path;
     model->unloadExcept(entry.path, preload);
     model->load(entry.path, async);
@@ -1290,9 +1345,8 @@ void Core::loadParentDir() {
     stopSlideshow();
     QFileInfo currentDir(model->directoryPath());
     QFileInfo parentDir(currentDir.absolutePath());
-    if(parentDir.exists() && parentDir.isReadable())
-        loadPath(parentDir.absoluteFilePath());
-    folderViewPresenter.selectAndFocus(currentDir.absoluteFilePath());
+    if(parentDir.exists() && parentDir.isReadable() && loadPath(parentDir.absoluteFilePath()))
+        state.pendingFocusPath = currentDir.absoluteFilePath();
 }
 
 void Core::nextDirectory() {
@@ -1311,8 +1365,7 @@ void Core::nextDirectory() {
                 return;
             QFileInfo fi(next);
             mw->showMessageDirectory(fi.baseName());
-            if(model->fileCount())
-                loadFileIndex(0, false, true);
+            state.pendingLoad = PENDING_FIRST;
         } else {
             mw->showMessageDirectoryEnd();
         }
@@ -1333,12 +1386,7 @@ void Core::prevDirectory(bool selectLast) {
                 return;
             QFileInfo fi(prev);
             mw->showMessageDirectory(fi.baseName());
-            if(model->fileCount()) {
-                if(selectLast)
-                    loadFileIndex(model->fileCount() - 1, false, true);
-                else
-                    loadFileIndex(0, false, true);
-            }
+            state.pendingLoad = selectLast ? PENDING_LAST : PENDING_FIRST;
         } else {
             mw->showMessageDirectoryStart();
         }
@@ -1354,7 +1402,7 @@ void Core::nextImage() {
         return;
     stopSlideshow();
     if(shuffle) {
-        loadFileIndex(randomizer.next(), true, false);
+        navigateTo(randomizer.next(), false);
         return;
     }
     int newIndex = model->indexOfFile(state.currentFilePath) + 1;
@@ -1370,7 +1418,7 @@ void Core::nextImage() {
             return;
         }
     }
-    loadFileIndex(newIndex, true, settings->usePreloader());
+    navigateTo(newIndex, settings->usePreloader());
 }
 
 void Core::prevImage() {
@@ -1378,7 +1426,7 @@ void Core::prevImage() {
         return;
     stopSlideshow();
     if(shuffle) {
-        loadFileIndex(randomizer.prev(), true, false);
+        navigateTo(randomizer.prev(), false);
         return;
     }
 
@@ -1395,7 +1443,83 @@ void Core::prevImage() {
             return;
         }
     }
-    loadFileIndex(newIndex, true, settings->usePreloader());
+    navigateTo(newIndex, settings->usePreloader());
+}
+
+// Each load would cancel the one before it (see Loader::loadAsyncPriority),
+// so while a key is held down nothing ever finishes decoding. Show what is
+// at hand instead and load the image navigation stops at.
+void Core::navigateTo(int index, bool preload) {
+    bool skimming = lastNavigation.isValid() && lastNavigation.elapsed() < SKIM_INTERVAL;
+    lastNavigation.restart();
+    if(!skimming) {
+        loadFileIndex(index, true, preload);
+        return;
+    }
+    skimTo(index);
+    skimTimer.start();
+}
+
+void Core::skimTo(int index) {
+    auto entry = model->fileEntryAt(index);
+    if(entry.path.isEmpty())
+        return;
+    state.currentFilePath = entry.path;
+    if(model->isLoaded(entry.path)) {
+        state.currentImg = model->getImage(entry.path);
+        guiSetImage(state.currentImg);
+    } else {
+        // keep the last one on screen if there is nothing to show
+        QImage preview = thumbnailer.cachedPreview(entry.path);
+        if(preview.isNull()) {
+            // the placeholder until the embedded preview is read;
+            // requests for the files we skimmed past are dropped
+            thumbnailer.clearTasks();
+            thumbnailer.getPreviewAsync(entry.path);
+            preview = thumbnailer.placeholder(entry.path);
+        }
+        if(!preview.isNull())
+            showPreview(preview);
+    }
+    thumbPanelPresenter.selectAndFocus(entry.path);
+    folderViewPresenter.selectAndFocus(entry.path);
+    updateInfoString();
+}
+
+void Core::onSkimPause() {
+    int index = model->indexOfFile(state.currentFilePath);
+    if(index != -1)
+        loadFileIndex(index, true, !shuffle && settings->usePreloader());
+}
+
+void Core::onPreviewReady(QImage preview, QString filePath) {
+    if(filePath != state.currentFilePath)
+        return;
+    // too late if the image itself got there first
+    if(!state.showingPreview && state.currentImg && state.currentImg->filePath() == filePath)
+        return;
+    showPreview(preview);
+}
+
+// scaled to the size the image itself first shows at, so that in the
+// default fit mode nothing moves when it replaces the preview
+void Core::showPreview(const QImage &preview) {
+    // the stored size is from before exif rotation, so only the scale is taken
+    // from it; the preview itself is already rotated and has the right aspect
+    int originalSide = qMax(preview.text("originalWidth").toInt(), preview.text("originalHeight").toInt());
+    QSize size = preview.size();
+    if(originalSide > 0)
+        size.scale(originalSide, originalSide, Qt::KeepAspectRatio);
+    QSize maxSize = mw->size() * qApp->devicePixelRatio();
+    if(originalSide <= 0 || size.width() > maxSize.width() || size.height() > maxSize.height())
+        size = preview.size().scaled(maxSize, Qt::KeepAspectRatio);
+    if(size.isEmpty())
+        return;
+    state.hasActiveImage = true;
+    state.showingPreview = true;
+    std::unique_ptr<QPixmap> pixmap(new QPixmap(QPixmap::fromImage(preview.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation))));
+    mw->showPreview(std::move(pixmap));
+    mw->setExifInfo(QMap<QString, QString>());
 }
 
 void Core::nextImageSlideshow() {
@@ -1459,22 +1583,10 @@ void Core::onModelItemReady(std::shared_ptr<Image> img, const QString &path) {
         state.currentImg = img;
         guiSetImage(img);
         updateInfoString();
-        if(state.delayModel) {
-            this->showGui();
-            state.delayModel = false;
-            QTimer::singleShot(40, this, SLOT(modelDelayLoad()));
-        }
         model->unloadExcept(state.currentFilePath, settings->usePreloader());
     }
 }
 
-void Core::modelDelayLoad() {
-    model->setDirectory(state.directoryPath);
-    mw->setDirectoryPath(state.directoryPath);
-    model->updateImage(state.currentFilePath, state.currentImg);
-    updateInfoString();
-}
-
 void Core::onModelItemUpdated(QString filePath) {
     if(filePath == state.currentFilePath) {
         guiSetImage(model->getImage(filePath));
@@ -1484,14 +1596,14 @@ void Core::onModelItemUpdated(QString filePath) {
 
 void Core::onModelSortingChanged(SortingMode mode) {
     mw->onSortingChanged(mode);
-    thumbPanelPresenter.reloadModel();
+    // the views were already reordered by their presenters
     thumbPanelPresenter.selectAndFocus(state.currentFilePath);
-    folderViewPresenter.reloadModel();
     folderViewPresenter.selectAndFocus(state.currentFilePath);
 }
 
 void Core::guiSetImage(std::shared_ptr<Image> img) {
     state.hasActiveImage = true;
+    state.showingPreview = false;
     if(!img) {
         mw->showMessage(tr("Error: could not load image."));
         return;
@@ -21,9 +21,19 @@
 #include <malloc.h>
 #endif
 
+// what to do once the directory listing is complete
+enum PendingLoad {
+    PENDING_NONE,
+    PENDING_FIRST,
+    PENDING_LAST
+};
+
 struct State {
     bool hasActiveImage = false;
-    bool delayModel = false;
+    // a preview stands in for the current image while skimming
+    bool showingPreview = false;
+    PendingLoad pendingLoad = PENDING_NONE;
+    QString pendingFocusPath = "";
     QString currentFilePath = "";
     QString directoryPath = "";
     std::shared_ptr<Image> currentImg;
@@ -83,6 +93,18 @@ private:
     void guiSetImage(std::shared_ptr<Image> img);
     QTimer slideshowTimer;
 
+    // skimming: while navigation is this fast (holding a key down) only
+    // previews are shown; the full load starts once it pauses
+    const int SKIM_INTERVAL = 100;
+    const int SKIM_PAUSE = 150;
+    QTimer skimTimer;
+    QElapsedTimer lastNavigation;
+    // reads embedded previews off the gui thread
+    Thumbnailer thumbnailer;
+    void navigateTo(int index, bool preload);
+    void skimTo(int index);
+    void showPreview(const QImage &preview);
+
     void startSlideshowTimer();
     void startSlideshow();
     void stopSlideshow();
@@ -104,6 +126,8 @@ private slots:
     void nextImage();
     void prevImage();
     void nextImageSlideshow();
+    void onSkimPause();
+    void onPreviewReady(QImage preview, QString filePath);
     void jumpToFirst();
     void jumpToLast();
     void onModelItemReady(std::shared_ptr<Image>, const QString&);
@@ -125,6 +149,8 @@ private slots:
     void onFileRemoved(QString filePath, int index);
     void onFileRenamed(QString fromPath, int indexFrom, QString toPath, int indexTo);
     void onFileAdded(QString filePath);
+    void onEntriesInserted(QList<int> dirIndices, QList<int> fileIndices);
+    void onEntriesRemoved(QList<int> dirIndices, QList<int> fileIndices, QStringList filePaths);
     void onFileModified(QString filePath);
     void showResizeDialog();
     void resize(QSize size);
@@ -157,6 +183,7 @@ private slots:
     void onDraggedOut(QList<QString> paths);
     void onDropIn(const QMimeData *mimeData, QObject* source);
     void toggleShuffle();
+    void onModelLoadStarted();
     void onModelLoaded();
     void outputError(const FileOpResult &error) const;
     void showOpenDialog();
@@ -174,5 +201,4 @@ private slots:
     void prevDirectory(bool selectLast);
     void prevDirectory();
     void print();
-    void modelDelayLoad();
 };
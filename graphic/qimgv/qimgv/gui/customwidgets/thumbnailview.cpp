@@ -10,6 +10,10 @@ ThumbnailView::ThumbnailView(Qt::Orientation _orientation, QWidget *parent)
       rangeSelection(false),
       selectMode(ACTIVATE_BY_PRESS),
       lastScrollFrameTime(0),
+      mVirtualMode(false),
+      mVirtualCount(0),
+      lastScrollValue(0),
+      mScrollVelocity(0),
       scrollTimeLine(nullptr)
 {
     setAccessibleName("thumbnailView");
@@ -42,11 +46,15 @@ ThumbnailView::ThumbnailView(Qt::Orientation _orientation, QWidget *parent)
     horizontalScrollBar()->setContextMenuPolicy(Qt::NoContextMenu);
     horizontalScrollBar()->installEventFilter(this);
     connect(horizontalScrollBar(), &QScrollBar::valueChanged, [this]() {
+        trackScrollVelocity(Qt::Horizontal);
+        updateLiveItems();
         loadVisibleThumbnails();
     });
     verticalScrollBar()->setContextMenuPolicy(Qt::NoContextMenu);
     verticalScrollBar()->installEventFilter(this);
     connect(verticalScrollBar(), &QScrollBar::valueChanged, [this]() {
+        trackScrollVelocity(Qt::Vertical);
+        updateLiveItems();
         loadVisibleThumbnails();
     });
     if(qApp->platformName() == "wayland")
@@ -132,78 +140,72 @@ void ThumbnailView::setDirectoryPath(QString path) {
     Q_UNUSED(path)
 }
 
-void ThumbnailView::select(QList<int> indices) {
-    for(auto i : mSelection)
-        thumbnails.at(i)->setHighlighted(false);
-    QList<int>::iterator it = indices.begin();
-    while(it != indices.end()) {
-        // sanity check
-        if(*it < 0 || *it >= itemCount()) {
-            it = indices.erase(it);
-        } else {
-            thumbnails.at(*it)->setHighlighted(true);
-            ++it;
-        }
-    }
-    mSelection = indices;
-    updateScrollbarIndicator();
+void ThumbnailView::select(const ItemSelection &newSelection) {
+    mSelection = newSelection;
+    // sanity check
+    mSelection.resize(itemCount());
+    applySelection();
 }
 
 void ThumbnailView::select(int index) {
     // fallback
     if(!checkRange(index))
         index = 0;
-    this->select(QList<int>() << index);
+    ItemSelection newSelection;
+    newSelection.add(index);
+    select(newSelection);
 }
 
 void ThumbnailView::deselect(int index) {
     if(!checkRange(index))
             return;
     if(mSelection.count() > 1) {
-        mSelection.removeAll(index);
-        thumbnails.at(index)->setHighlighted(false);
+        mSelection.remove(index);
+        if(auto widget = itemWidget(index))
+            widget->setHighlighted(false);
+        updateScrollbarIndicator();
     }
 }
 
 void ThumbnailView::addSelectionRange(int indexTo) {
-    if(!rangeSelectionSnapshot.count() || !selection().count())
+    if(rangeSelectionSnapshot.isEmpty() || mSelection.isEmpty())
         return;
-    auto list = rangeSelectionSnapshot;
-    if(indexTo > rangeSelectionSnapshot.last()) {
-        for(int i = rangeSelectionSnapshot.last() + 1; i <= indexTo; i++) {
-            if(list.contains(i))
-                list.removeAll(i);
-            list << i;
-        }
-    } else {
-        for(int i = rangeSelectionSnapshot.last() - 1; i >= indexTo; i--) {
-            if(list.contains(i))
-                list.removeAll(i);
-            list << i;
-        }
-    }
-    select(list);
+    auto newSelection = rangeSelectionSnapshot;
+    newSelection.addRange(rangeSelectionSnapshot.last(), indexTo);
+    select(newSelection);
 }
 
-QList<int> ThumbnailView::selection() {
+const ItemSelection &ThumbnailView::selection() {
     return mSelection;
 }
 
 void ThumbnailView::clearSelection() {
-    for(auto i : mSelection)
-        thumbnails.at(i)->setHighlighted(false);
     mSelection.clear();
+    applySelection();
 }
 
 int ThumbnailView::lastSelected() {
-    if(!selection().count())
-        return -1;
-    else
-        return selection().last();
+    return mSelection.last();
+}
+
+// the one place a selection change shows up; only widgets that exist are touched
+void ThumbnailView::applySelection() {
+    if(mVirtualMode) {
+        for(auto it = liveItems.constBegin(); it != liveItems.constEnd(); ++it)
+            it.value()->setHighlighted(mSelection.contains(it.key()));
+    } else {
+        for(int i = 0; i < thumbnails.count(); i++)
+            thumbnails.at(i)->setHighlighted(mSelection.contains(i));
+    }
+    updateScrollbarIndicator();
+}
+
+const ThumbnailLru &ThumbnailView::thumbnailLru() const {
+    return mThumbnailLru;
 }
 
 int ThumbnailView::itemCount() {
-    return thumbnails.count();
+    return mVirtualMode ? mVirtualCount : thumbnails.count();
 }
 
 void ThumbnailView::show() {
@@ -261,14 +263,17 @@ void ThumbnailView::populate(int newCount) {
         }
         */
 
-        if(newCount == thumbnails.count()) {
-            QList<ThumbnailWidget*>::iterator i;
-            for (i = thumbnails.begin(); i != thumbnails.end(); ++i) {
-                (*i)->reset();
-            }
+        bool virtualMode = (newCount >= VIRTUAL_MODE_THRESHOLD);
+        if(newCount == itemCount() && virtualMode == mVirtualMode) {
+            for(auto widget : allWidgets())
+                widget->reset();
         } else {
+            clearLiveItems();
             removeAll();
-            for(int i = 0; i < newCount; i++) {
+            mVirtualMode = virtualMode;
+            mVirtualCount = mVirtualMode ? newCount : 0;
+            // virtual mode: widgets are made as the items scroll into view
+            for(int i = 0; !mVirtualMode && i < newCount; i++) {
                 ThumbnailWidget *widget = createThumbnailWidget();
                 widget->setThumbnailSize(mThumbnailSize);
                 thumbnails.append(widget);
@@ -276,6 +281,7 @@ void ThumbnailView::populate(int newCount) {
             }
         }
     }
+    mThumbnailLru.clear();
     updateLayout();
     fitSceneToContents();
     resetViewport();
@@ -287,55 +293,188 @@ void ThumbnailView::populate(int newCount) {
 }
 
 void ThumbnailView::addItem() {
-    insertItem(thumbnails.count());
+    insertItem(itemCount());
 }
 
 // insert at index
 void ThumbnailView::insertItem(int index) {
-    ThumbnailWidget *widget = createThumbnailWidget();
-    thumbnails.insert(index, widget);
-    addItemToLayout(widget, index);
+    if(mVirtualMode) {
+        mVirtualCount++;
+        shiftLiveItems(index, 1);
+    } else {
+        ThumbnailWidget *widget = createThumbnailWidget();
+        thumbnails.insert(index, widget);
+        addItemToLayout(widget, index);
+    }
+    mThumbnailLru.shift(index, 1);
+    mSelection.insertAt(index);
     updateLayout();
     fitSceneToContents();
+    applySelection();
+    loadVisibleThumbnails();
+}
 
-    auto newSelection = mSelection;
-    for(int i=0; i < newSelection.count(); i++) {
-        if(index <= newSelection[i])
-            newSelection[i]++;
+// insert several items at once; indices are final positions, ascending
+void ThumbnailView::insertItems(QList<int> indices) {
+    int oldCount = itemCount();
+    QList<int> inserted;
+    for(auto index : indices) {
+        if(index < 0 || index > oldCount + inserted.count() || (!inserted.isEmpty() && index <= inserted.last()))
+            continue;
+        inserted << index;
     }
-    select(newSelection);
-
-    updateScrollbarIndicator();
+    if(inserted.isEmpty())
+        return;
+    // one index map for the whole batch; order[new] == old, -1 for the new items
+    int newCount = oldCount + inserted.count();
+    QList<int> order, newIndex;
+    order.reserve(newCount);
+    newIndex.reserve(oldCount);
+    for(int i = 0, n = 0; i < newCount; i++) {
+        if(n < inserted.count() && inserted.at(n) == i) {
+            order << -1;
+            n++;
+            continue;
+        }
+        order << newIndex.count();
+        newIndex << i;
+    }
+    if(mVirtualMode) {
+        mVirtualCount = newCount;
+        remapLiveItems(newIndex);
+    } else {
+        for(auto index : inserted) {
+            ThumbnailWidget *widget = createThumbnailWidget();
+            thumbnails.insert(index, widget);
+            addItemToLayout(widget, index);
+        }
+    }
+    mThumbnailLru.reorder(newIndex);
+    mSelection.reorder(order);
+    updateLayout();
+    fitSceneToContents();
+    applySelection();
     loadVisibleThumbnails();
 }
 
 void ThumbnailView::removeItem(int index) {
     if(checkRange(index)) {
-        auto newSelection = mSelection;
-        clearSelection();
-        removeItemFromLayout(index);
-        delete thumbnails.takeAt(index);
+        takeItem(index);
         fitSceneToContents();
-        newSelection.removeAll(index);
-        for(int i=0; i < newSelection.count(); i++) {
-            if(newSelection[i] >= index)
-                newSelection[i]--;
-        }
-        if(!newSelection.count() && itemCount())
-            newSelection << ((index >= itemCount()) ? itemCount() - 1 : index);
-        select(newSelection);
-        updateScrollbarIndicator();
+        mSelection.removeAt(index);
+        if(mSelection.isEmpty() && itemCount())
+            mSelection.add((index >= itemCount()) ? itemCount() - 1 : index);
+        applySelection();
         loadVisibleThumbnails();
     }
 }
 
+// remove several items at once; indices are positions before the removal, ascending
+void ThumbnailView::removeItems(QList<int> indices) {
+    int oldCount = itemCount();
+    QList<int> removed;
+    for(auto index : indices) {
+        if(!checkRange(index) || (!removed.isEmpty() && index <= removed.last()))
+            continue;
+        removed << index;
+    }
+    if(removed.isEmpty())
+        return;
+    // one index map for the whole batch; newIndex[old] == new, -1 for the removed items
+    QList<int> newIndex, order;
+    newIndex.reserve(oldCount);
+    order.reserve(oldCount - removed.count());
+    for(int i = 0, n = 0; i < oldCount; i++) {
+        if(n < removed.count() && removed.at(n) == i) {
+            newIndex << -1;
+            n++;
+            continue;
+        }
+        newIndex << order.count();
+        order << i;
+    }
+    if(mVirtualMode) {
+        mVirtualCount = order.count();
+        remapLiveItems(newIndex);
+    } else {
+        // back to front so the remaining indices stay valid
+        for(int n = removed.count() - 1; n >= 0; n--) {
+            removeItemFromLayout(removed.at(n));
+            delete thumbnails.takeAt(removed.at(n));
+        }
+    }
+    mThumbnailLru.reorder(newIndex);
+    mSelection.reorder(order);
+    fitSceneToContents();
+    int first = removed.first();
+    if(mSelection.isEmpty() && itemCount())
+        mSelection.add((first >= itemCount()) ? itemCount() - 1 : first);
+    applySelection();
+    loadVisibleThumbnails();
+}
+
+// removes & deletes the item's widget, if it has one
+void ThumbnailView::takeItem(int index) {
+    if(mVirtualMode) {
+        if(auto widget = liveItems.take(index))
+            releaseWidget(widget);
+        shiftLiveItems(index + 1, -1);
+        mVirtualCount--;
+    } else {
+        removeItemFromLayout(index);
+        delete thumbnails.takeAt(index);
+    }
+    mThumbnailLru.remove(index);
+    mThumbnailLru.shift(index + 1, -1);
+}
+
 void ThumbnailView::reloadItem(int index) {
-    if(!checkRange(index))
+    // off screen in virtual mode; loaded when it scrolls in
+    auto thumb = itemWidget(index);
+    if(!thumb)
         return;
-    auto thumb = thumbnails.at(index);
     if(thumb->isLoaded)
         thumb->unsetThumbnail();
-    emit thumbnailsRequested(QList<int>() << index, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, true);
+    mThumbnailLru.remove(index);
+    emit thumbnailsRequested(QList<int>() << index, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, true, false);
+}
+
+// Items keep their widgets & loaded thumbnails and are only moved.
+void ThumbnailView::reorderItems(QList<int> order) {
+    // inverse; also checks that this is a permutation of our items
+    QList<int> newIndex;
+    newIndex.reserve(order.count());
+    for(int i = 0; i < order.count(); i++)
+        newIndex << -1;
+    bool valid = (order.count() == itemCount());
+    for(int i = 0; valid && i < order.count(); i++) {
+        valid = checkRange(order.at(i)) && newIndex.at(order.at(i)) == -1;
+        if(valid)
+            newIndex[order.at(i)] = i;
+    }
+    if(!valid) {
+        populate(order.count());
+        return;
+    }
+    if(mVirtualMode) {
+        remapLiveItems(newIndex);
+    } else {
+        QList<ThumbnailWidget*> moved;
+        moved.reserve(thumbnails.count());
+        for(auto i : order)
+            moved << thumbnails.at(i);
+        thumbnails.swap(moved);
+        reorderLayout(order);
+    }
+    mThumbnailLru.reorder(newIndex);
+    mSelection.reorder(order);
+    updateLayout();
+    if(mVirtualMode) {
+        layoutLiveItems();
+        updateLiveItems();
+    }
+    applySelection();
+    loadVisibleThumbnails();
 }
 
 void ThumbnailView::setDragHover(int index) {
@@ -355,14 +494,47 @@ void ThumbnailView::setDrawScrollbarIndicator(bool mode) {
 }
 
 void ThumbnailView::setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) {
-    if(thumb && thumb->size() == floor(mThumbnailSize * qApp->devicePixelRatio()) && checkRange(pos)) {
-        thumbnails.at(pos)->setThumbnail(thumb);
+    if(thumb && thumb->size() == floor(mThumbnailSize * qApp->devicePixelRatio())) {
+        // items that already scrolled away are kept too, until the budget runs out
+        auto pixmap = thumb->pixmap();
+        qint64 bytes = pixmap ? static_cast<qint64>(pixmap->width()) * pixmap->height() * pixmap->depth() / 8 : 0;
+        // the widget keeps a 32bpp tile of its own size too, see ThumbnailWidget::updateTile()
+        QSizeF tileSize = itemSceneRect(pos).size() * qApp->devicePixelRatio();
+        bytes += static_cast<qint64>(tileSize.width()) * static_cast<qint64>(tileSize.height()) * 4;
+        mThumbnailLru.setThumbnailSize(thumb->size());
+        auto evicted = mThumbnailLru.insert(pos, thumb, bytes);
+        if(auto widget = itemWidget(pos))
+            widget->setThumbnail(thumb);
+        unloadThumbnails(evicted);
+    }
+}
+
+void ThumbnailView::setPlaceholder(int pos, const QImage &image) {
+    auto widget = itemWidget(pos);
+    if(!widget || widget->isLoaded || image.isNull())
+        return;
+    if(mCropThumbnails) {
+        // same center crop as the thumbnail will have
+        int side = qMin(image.width(), image.height());
+        QRect square(0, 0, side, side);
+        square.moveCenter(image.rect().center());
+        widget->setPlaceholder(image.copy(square));
+    } else {
+        widget->setPlaceholder(image);
     }
 }
 
 void ThumbnailView::unloadAllThumbnails() {
-    for(int i = 0; i < thumbnails.count(); i++) {
-        thumbnails.at(i)->unsetThumbnail();
+    for(auto widget : allWidgets())
+        widget->unsetThumbnail();
+    mThumbnailLru.clear();
+}
+
+// evicted by the lru
+void ThumbnailView::unloadThumbnails(const QList<int> &indices) {
+    for(auto index : indices) {
+        if(auto widget = itemWidget(index))
+            widget->unsetThumbnail();
     }
 }
 
@@ -370,45 +542,76 @@ void ThumbnailView::loadVisibleThumbnails() {
     loadTimer.stop();
     if(isVisible() && !blockThumbnailLoading) {
         QRectF visRect = mapToScene(viewport()->geometry()).boundingRect();
+        qreal back, front;
+        preloadArea(back, front);
+        // too fast to keep up with; take what is cached and load the rest once it slows down
+        bool cacheOnly = qAbs(scrollVelocity()) > FLING_VELOCITY;
         QRectF offRectBack;
         QRectF offRectFront;
         if(mOrientation == Qt::Horizontal) {
-            offRectBack  = QRectF(visRect.left() - offscreenPreloadArea, visRect.top(),
-                                  offscreenPreloadArea, visRect.height());
+            offRectBack  = QRectF(visRect.left() - back, visRect.top(),
+                                  back, visRect.height());
             offRectFront = QRectF(visRect.right(), visRect.top(),
-                                  offscreenPreloadArea, visRect.height());
+                                  front, visRect.height());
         } else {
-            offRectBack  = QRectF(visRect.left(), visRect.top() - offscreenPreloadArea,
-                                  visRect.width(), offscreenPreloadArea);
+            offRectBack  = QRectF(visRect.left(), visRect.top() - back,
+                                  visRect.width(), back);
             offRectFront = QRectF(visRect.left(), visRect.bottom(),
-                                  visRect.width(), offscreenPreloadArea);
+                                  visRect.width(), front);
         }
-        QList<QGraphicsItem *>visibleItems;
-        if(lastScrollDirection == SCROLL_FORWARDS)
-            visibleItems = scene.items(visRect, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder);
-        else
-            visibleItems = scene.items(visRect, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder);
-        visibleItems.append(scene.items(offRectBack,  Qt::IntersectsItemBoundingRect, Qt::DescendingOrder));
-        visibleItems.append(scene.items(offRectFront, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder));
-        // select
+        updateLiveItems();
+        // index ranges straight from the layout; items on the edges
+        // are counted in the visible range only
+        int first, last, backFirst, backLast, frontFirst, frontLast;
+        itemRange(visRect, first, last);
+        itemRange(offRectBack, backFirst, backLast);
+        itemRange(offRectFront, frontFirst, frontLast);
+        if(last < first) {
+            backLast = first - 1;
+            frontFirst = last + 1;
+        } else {
+            backLast = qMin(backLast, first - 1);
+            frontFirst = qMax(frontFirst, last + 1);
+        }
+        // select; whatever the lru still has is set right away
+        int size = static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize);
+        mThumbnailLru.setThumbnailSize(size);
         QList<int> loadList;
-        for(int i = 0; i < visibleItems.count(); i++) {
-            ThumbnailWidget* widget = qgraphicsitem_cast<ThumbnailWidget*>(visibleItems.at(i));
-            if(widget && !widget->isLoaded) {
-                int idx = thumbnails.indexOf(widget);
-                if(!loadList.contains(idx))
-                    loadList.append(idx);
+        auto addRange = [&](int from, int to, bool ascending) {
+            for(int n = 0; n <= to - from; n++) {
+                int index = ascending ? from + n : to - n;
+                auto widget = itemWidget(index);
+                if(!widget || widget->isLoaded)
+                    continue;
+                // a miss counts once per request, not on every pass while it's loading
+                if(auto thumb = mThumbnailLru.get(index, !widget->isRequested)) {
+                    widget->setThumbnail(thumb);
+                } else {
+                    widget->isRequested = true;
+                    loadList << index;
+                }
             }
-        }
+        };
+        addRange(first, last, lastScrollDirection == SCROLL_FORWARDS);
+        addRange(backFirst, backLast, false);
+        addRange(frontFirst, frontLast, true);
         // load
-        if(loadList.count())
-            emit thumbnailsRequested(loadList, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, false);
-        // unload offscreen
-        if(settings->unloadThumbs()) {
-            for(int i = 0; i < thumbnails.count(); i++)
-                if(!visibleItems.contains(thumbnails.at(i)))
-                    thumbnails.at(i)->unsetThumbnail();
+        if(loadList.count()) {
+            emit thumbnailsRequested(loadList, size, mCropThumbnails, false, cacheOnly);
+            if(cacheOnly)
+                loadVisibleThumbnailsDelayed();
         }
+        // keep the preload area, and some more of what is coming up next
+        int keepFirst = (backFirst <= backLast) ? backFirst : first;
+        int keepLast = (frontFirst <= frontLast) ? frontLast : last;
+        int ahead = (last - first + 1) * KEEP_AHEAD_PAGES;
+        if(lastScrollDirection == SCROLL_FORWARDS)
+            keepLast += ahead;
+        else
+            keepFirst -= ahead;
+        mThumbnailLru.setBudget(settings->unloadThumbs() ? THUMBNAIL_BUDGET_LOW : THUMBNAIL_BUDGET);
+        mThumbnailLru.setWindow(first, last, keepFirst, keepLast);
+        unloadThumbnails(mThumbnailLru.trim());
     }
 }
 
@@ -450,7 +653,118 @@ bool ThumbnailView::atSceneEnd() {
 }
 
 bool ThumbnailView::checkRange(int pos) {
-    return pos >= 0 && pos < thumbnails.count();
+    return pos >= 0 && pos < itemCount();
+}
+
+ThumbnailWidget *ThumbnailView::itemWidget(int index) {
+    if(mVirtualMode)
+        return liveItems.value(index, nullptr);
+    return checkRange(index) ? thumbnails.at(index) : nullptr;
+}
+
+int ThumbnailView::indexOfWidget(ThumbnailWidget *widget) {
+    if(mVirtualMode)
+        return liveItems.key(widget, -1);
+    return thumbnails.indexOf(widget);
+}
+
+QList<ThumbnailWidget*> ThumbnailView::allWidgets() {
+    if(mVirtualMode)
+        return liveItems.values() + spareItems;
+    return thumbnails;
+}
+
+QRectF ThumbnailView::itemSceneRect(int index) {
+    if(!mVirtualMode && checkRange(index)) {
+        ThumbnailWidget *widget = thumbnails.at(index);
+        return widget->mapRectToScene(widget->rect());
+    }
+    return itemRect(index);
+}
+
+// Virtual mode: gives a widget to every item in the viewport and within
+// the preload area around it, takes them away from the rest.
+void ThumbnailView::updateLiveItems() {
+    if(!mVirtualMode)
+        return;
+    qreal back, front;
+    preloadArea(back, front);
+    QRectF liveRect = mapToScene(viewport()->rect()).boundingRect();
+    if(mOrientation == Qt::Horizontal)
+        liveRect.adjust(-back, 0, front, 0);
+    else
+        liveRect.adjust(0, -back, 0, front);
+    int first, last;
+    itemRange(liveRect, first, last);
+    for(auto it = liveItems.begin(); it != liveItems.end();) {
+        if(it.key() < first || it.key() > last) {
+            releaseWidget(it.value());
+            it = liveItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for(int i = first; i <= last; i++) {
+        if(!liveItems.contains(i))
+            liveItems.insert(i, acquireWidget(i));
+    }
+}
+
+// after the layout has changed (resize, insertion...)
+void ThumbnailView::layoutLiveItems() {
+    for(auto it = liveItems.constBegin(); it != liveItems.constEnd(); ++it)
+        it.value()->setGeometry(itemRect(it.key()));
+}
+
+void ThumbnailView::clearLiveItems() {
+    qDeleteAll(liveItems);
+    qDeleteAll(spareItems);
+    liveItems.clear();
+    spareItems.clear();
+}
+
+// items from index "from" onward moved by delta
+void ThumbnailView::shiftLiveItems(int from, int delta) {
+    QHash<int, ThumbnailWidget*> shifted;
+    shifted.reserve(liveItems.count());
+    for(auto it = liveItems.constBegin(); it != liveItems.constEnd(); ++it)
+        shifted.insert(it.key() >= from ? it.key() + delta : it.key(), it.value());
+    liveItems.swap(shifted);
+}
+
+// item i moved to newIndex[i]; the widgets of items mapped to -1 are released
+void ThumbnailView::remapLiveItems(const QList<int> &newIndex) {
+    QHash<int, ThumbnailWidget*> moved;
+    moved.reserve(liveItems.count());
+    for(auto it = liveItems.constBegin(); it != liveItems.constEnd(); ++it) {
+        int index = (it.key() < newIndex.count()) ? newIndex.at(it.key()) : -1;
+        if(index < 0)
+            releaseWidget(it.value());
+        else
+            moved.insert(index, it.value());
+    }
+    liveItems.swap(moved);
+}
+
+ThumbnailWidget *ThumbnailView::acquireWidget(int index) {
+    ThumbnailWidget *widget;
+    if(spareItems.isEmpty()) {
+        widget = createThumbnailWidget();
+        scene.addItem(widget);
+    } else {
+        widget = spareItems.takeLast();
+        widget->show();
+    }
+    widget->setGeometry(itemRect(index));
+    widget->setHighlighted(mSelection.contains(index));
+    return widget;
+}
+
+void ThumbnailView::releaseWidget(ThumbnailWidget *widget) {
+    widget->reset();
+    widget->setDropHovered(false);
+    widget->hide();
+    spareItems << widget;
 }
 
 void ThumbnailView::updateLayout() {
@@ -460,17 +774,25 @@ void ThumbnailView::updateLayout() {
 // fit scene to it's contents size
 void ThumbnailView::fitSceneToContents() {
     QPointF center;
+    QSizeF contents;
+    if(mVirtualMode) {
+        layoutLiveItems();
+        contents = contentsSize();
+    } else {
+        contents = scene.itemsBoundingRect().size();
+    }
     if(this->mOrientation == Qt::Vertical) {
-        int height = qMax((int)scene.itemsBoundingRect().height(), this->height());
+        int height = qMax((int)contents.height(), this->height());
         scene.setSceneRect(QRectF(0,0, this->width(), height));
         center = mapToScene(viewport()->rect().center());
         QGraphicsView::centerOn(0, center.y() + 1);
     } else {
-        int width = qMax((int)scene.itemsBoundingRect().width(), this->width());
+        int width = qMax((int)contents.width(), this->width());
         scene.setSceneRect(QRectF(0,0, width, this->height()));
         center = mapToScene(viewport()->rect().center());
         QGraphicsView::centerOn(center.x() + 1, 0);
     }
+    updateLiveItems();
 }
 
 //################### scrolling ######################
@@ -535,47 +857,40 @@ void ThumbnailView::scrollPrecise(int delta) {
 void ThumbnailView::scrollByItem(int delta) {
     // do not scroll less than a certain value in px, to avoid feeling unresponsive
     int minScroll = qMin(thumbnailSize() / 2, 100);
-    // grab fully visible thumbs
+    // grab fully visible thumbs, by index (widgets are recycled in virtual mode)
     QRectF visRect = mapToScene(viewport()->geometry()).boundingRect().adjusted(-minScroll,-minScroll,minScroll,minScroll);
-    QList<QGraphicsItem *> visibleItems;
-    visibleItems = scene.items(visRect, Qt::ContainsItemBoundingRect, Qt::AscendingOrder);
-    if(thumbnails.isEmpty() || visibleItems.isEmpty())
+    int first, last;
+    itemRange(visRect, first, last);
+    while(first <= last && !visRect.contains(itemSceneRect(first)))
+        first++;
+    while(last >= first && !visRect.contains(itemSceneRect(last)))
+        last--;
+    if(!itemCount() || last < first)
         return;
-    int target = 0;
     // select scroll target
-    if(delta > 0) { // up / left
-        ThumbnailWidget* widget = qgraphicsitem_cast<ThumbnailWidget*>(visibleItems.first());
-        if(!widget)
-            return;
-        target = thumbnails.indexOf(widget) - 1;
-    } else { // down / right
-        ThumbnailWidget* widget = qgraphicsitem_cast<ThumbnailWidget*>(visibleItems.last());
-        if(!widget)
-            return;
-        target = thumbnails.indexOf(widget) + 1;
-    }
+    int target = (delta > 0) ? first - 1  // up / left
+                             : last + 1;  // down / right
     scrollToItem(target);
 }
 
 void ThumbnailView::scrollToItem(int index) {
     if(!checkRange(index))
         return;
-    ThumbnailWidget *item = thumbnails.at(index);
     QRectF sceneRect = mapToScene(viewport()->rect()).boundingRect();
-    QRectF itemRect = item->mapRectToScene(item->rect());
-    bool visible = sceneRect.contains(itemRect);
+    QRectF targetRect = itemSceneRect(index);
+    bool visible = sceneRect.contains(targetRect);
     if(!visible) {
         int delta = 0;
         if(mOrientation == Qt::Vertical) {
-            if(itemRect.top() >= sceneRect.top()) // UP
-                delta = sceneRect.bottom() - itemRect.bottom();
+            if(targetRect.top() >= sceneRect.top()) // UP
+                delta = sceneRect.bottom() - targetRect.bottom();
             else // DOWN
-                delta = sceneRect.top() - itemRect.top();
+                delta = sceneRect.top() - targetRect.top();
         } else {
-            if(itemRect.left() >= sceneRect.left()) // LEFT
-                delta = sceneRect.right() - itemRect.right();
+            if(targetRect.left() >= sceneRect.left()) // LEFT
+                delta = sceneRect.right() - targetRect.right();
             else // RIGHT
-                delta = sceneRect.left() - itemRect.left();
+                delta = sceneRect.left() - targetRect.left();
         }
         if(settings->enableSmoothScroll())
             scrollSmooth(delta);
@@ -616,18 +931,62 @@ void ThumbnailView::scrollSmooth(int delta, qreal multiplier, qreal acceleration
             createScrollTimeLine();
         if(!redirect && additive)
             newEndFrame = oldEndFrame - static_cast<int>(delta * multiplier * acceleration);
-        // force load thumbs inbetween scroll animations
-        blockThumbnailLoading = false;
-        loadVisibleThumbnails();
     }
     scrollTimeLine->stop();
     if(accelerate)
         scrollTimeLine->setDuration(SCROLL_DURATION / SCROLL_ACCELERATION);
     else
         scrollTimeLine->setDuration(SCROLL_DURATION);
-    blockThumbnailLoading = true;
     scrollTimeLine->setFrameRange(center, newEndFrame);
     scrollTimeLine->start();
+    // request up to where the animation is heading, nothing while it runs
+    blockThumbnailLoading = false;
+    loadVisibleThumbnails();
+    blockThumbnailLoading = true;
+}
+
+// px to preload before / after the viewport. Grows in the direction of
+// travel with the scroll speed (or the distance left to animate), shrinks behind.
+void ThumbnailView::preloadArea(qreal &back, qreal &front) {
+    qreal velocity = scrollVelocity();
+    bool forwards = velocity ? (velocity > 0) : (lastScrollDirection == SCROLL_FORWARDS);
+    qreal extra = qAbs(velocity) * PREFETCH_TIME;
+    if(scrollTimeLine && scrollTimeLine->state() == QTimeLine::Running)
+        extra = qMax(extra, static_cast<qreal>(qAbs(scrollTimeLine->endFrame() - scrollTimeLine->currentFrame())));
+    extra = qMin(extra, offscreenPreloadArea * 3.0);
+    qreal ahead = offscreenPreloadArea + extra;
+    qreal behind = qMax(offscreenPreloadArea - extra, offscreenPreloadArea / 4.0);
+    back = forwards ? behind : ahead;
+    front = forwards ? ahead : behind;
+}
+
+// sampled from scroll position changes
+void ThumbnailView::trackScrollVelocity(Qt::Orientation scrolled) {
+    if(scrolled != mOrientation)
+        return;
+    int value = (mOrientation == Qt::Horizontal) ? horizontalScrollBar()->value() : verticalScrollBar()->value();
+    qreal elapsed = velocityTimer.isValid() ? velocityTimer.nsecsElapsed() / 1000000.0 : 0;
+    velocityTimer.start();
+    if(elapsed <= 0 || elapsed > VELOCITY_TIMEOUT)
+        mScrollVelocity = 0; // just started moving
+    else
+        mScrollVelocity = 0.6 * (value - lastScrollValue) / qMax(elapsed, 1.0) + 0.4 * mScrollVelocity;
+    lastScrollValue = value;
+}
+
+// px / ms, positive forwards. A running scroll animation counts with the
+// speed it needs to reach its end frame.
+qreal ThumbnailView::scrollVelocity() {
+    qreal velocity = 0;
+    if(velocityTimer.isValid() && velocityTimer.elapsed() <= VELOCITY_TIMEOUT)
+        velocity = mScrollVelocity;
+    if(scrollTimeLine && scrollTimeLine->state() == QTimeLine::Running) {
+        qreal remaining = qMax(scrollTimeLine->duration() - scrollTimeLine->currentTime(), 1);
+        qreal planned = (scrollTimeLine->endFrame() - scrollTimeLine->currentFrame()) / remaining;
+        if(qAbs(planned) > qAbs(velocity))
+            velocity = planned;
+    }
+    return velocity;
 }
 
 void ThumbnailView::scrollSmooth(int delta, qreal multiplier, qreal acceleration) {
@@ -643,13 +1002,16 @@ void ThumbnailView::mousePressEvent(QMouseEvent *event) {
     dragStartPos = QPoint(0,0);
     ThumbnailWidget *item = dynamic_cast<ThumbnailWidget*>(itemAt(event->pos()));
     if(item) {
-        int index = thumbnails.indexOf(item);
+        int index = indexOfWidget(item);
         if(event->button() == Qt::LeftButton) {
             if(event->modifiers() & Qt::ControlModifier) {
-                if(!selection().contains(index))
-                    select(selection() << index);
-                else
+                if(!selection().contains(index)) {
+                    auto newSelection = selection();
+                    newSelection.add(index);
+                    select(newSelection);
+                } else {
                     deselect(index);
+                }
             } else if(event->modifiers() & Qt::ShiftModifier) {
                 addSelectionRange(index);
             } else if (selection().count() <= 1) {
@@ -677,7 +1039,7 @@ void ThumbnailView::mouseMoveEvent(QMouseEvent *event) {
         return;
     if(QLineF(dragStartPos, event->pos()).length() >= 40) {
         auto *item = dynamic_cast<ThumbnailWidget*>(itemAt(dragStartPos));
-        if(item && selection().contains(thumbnails.indexOf(item)))
+        if(item && selection().contains(indexOfWidget(item)))
             emit draggedOut();
     }
 }
@@ -687,7 +1049,7 @@ void ThumbnailView::mouseReleaseEvent(QMouseEvent *event) {
     if(mouseReleaseSelect && QLineF(dragStartPos, event->pos()).length() < 40) {
         ThumbnailWidget *item = dynamic_cast<ThumbnailWidget*>(itemAt(event->pos()));
         if(item) {
-            int index = thumbnails.indexOf(item);
+            int index = indexOfWidget(item);
             select(index);
         }
     }
@@ -697,7 +1059,7 @@ void ThumbnailView::mouseDoubleClickEvent(QMouseEvent *event) {
     if(event->button() == Qt::LeftButton) {
         ThumbnailWidget *item = dynamic_cast<ThumbnailWidget*>(itemAt(event->pos()));
         if(item) {
-            emit itemActivated(thumbnails.indexOf(item));
+            emit itemActivated(indexOfWidget(item));
             return;
         }
     }
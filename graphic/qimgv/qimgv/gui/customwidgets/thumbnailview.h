@@ -5,6 +5,15 @@
  * It doesn't do actual positioning of thumbnails within the scene.
  * (But maybe it should?)
  *
+ * Big folders (VIRTUAL_MODE_THRESHOLD items and up) are shown in virtual
+ * mode: only the items in / near the viewport get a ThumbnailWidget,
+ * widgets are recycled while scrolling and placed by the subclass'
+ * itemRect(). Use itemWidget() / indexOfWidget() rather than the
+ * thumbnails list, which is only filled in normal mode.
+ *
+ * Loaded thumbnails are also kept in mThumbnailLru (within a memory
+ * budget), so items that come back into view do not need a new request.
+ *
  * Usage: subclass, implement layout-related stuff
  */
 
@@ -17,9 +26,12 @@
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QScreen>
+#include <QHash>
+#include <QSet>
 
 #include "gui/customwidgets/thumbnailwidget.h"
 #include "gui/idirectoryview.h"
+#include "components/cache/thumbnaillru.h"
 #include "shortcutbuilder.h"
 
 enum ThumbnailSelectMode {
@@ -38,10 +50,11 @@ class ThumbnailView : public QGraphicsView, public IDirectoryView {
 public:
     ThumbnailView(Qt::Orientation orient, QWidget *parent = nullptr);
     virtual void setDirectoryPath(QString path) override;
-    void select(QList<int>) override;
+    void select(const ItemSelection &) override;
     void select(int) override;
-    QList<int> selection() override;
+    const ItemSelection &selection() override;
     int itemCount();
+    const ThumbnailLru &thumbnailLru() const;
 
     void setSelectMode(ThumbnailSelectMode mode);
     int lastSelected();
@@ -61,14 +74,18 @@ public slots:
     virtual void focusOnSelection() = 0;
     virtual void populate(int count) override;
     virtual void setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) override;
+    virtual void setPlaceholder(int pos, const QImage &image) override;
     virtual void insertItem(int index) override;
+    virtual void insertItems(QList<int> indices) override;
     virtual void removeItem(int index) override;
+    virtual void removeItems(QList<int> indices) override;
     virtual void reloadItem(int index) override;
+    virtual void reorderItems(QList<int> order) override;
     virtual void setDragHover(int index) override;
 
 signals:
     void itemActivated(int) override;
-    void thumbnailsRequested(QList<int>, int, bool, bool) override;
+    void thumbnailsRequested(QList<int>, int, bool, bool, bool) override;
     void draggedOut() override;
     void draggedToBookmarks(QList<int>) override;
     void draggedOver(int) override;
@@ -79,7 +96,7 @@ private:
     bool blockThumbnailLoading;
 
     int mDrawScrollbarIndicator, lastScrollFrameTime;
-    QList<int> mSelection;
+    ItemSelection mSelection;
 
     bool mCropThumbnails, mouseReleaseSelect;
     ThumbnailSelectMode selectMode;
@@ -87,6 +104,15 @@ private:
     ThumbnailWidget* dragTarget;
 
     void createScrollTimeLine();
+    void applySelection();
+    void takeItem(int index);
+    void unloadThumbnails(const QList<int> &indices);
+    void trackScrollVelocity(Qt::Orientation scrolled);
+    qreal scrollVelocity();
+    void preloadArea(qreal &back, qreal &front);
+    int lastScrollValue;
+    qreal mScrollVelocity;
+    QElapsedTimer velocityTimer;
     QElapsedTimer scrollFrameTimer;
     std::function<void(int)> centerOn;
     QElapsedTimer lastTouchpadScroll;
@@ -95,13 +121,27 @@ private:
 protected:
     QGraphicsScene scene;
     QList<ThumbnailWidget*> thumbnails;
+    // virtual mode
+    bool mVirtualMode;
+    int mVirtualCount;
+    QHash<int, ThumbnailWidget*> liveItems;
+    QList<ThumbnailWidget*> spareItems;
+    const int VIRTUAL_MODE_THRESHOLD = 1000;
+    // loaded thumbnails, widget or not; entries are charged for the widget tile as well
+    ThumbnailLru mThumbnailLru;
+    const qint64 THUMBNAIL_BUDGET = 256 * 1024 * 1024;
+    // "unload offscreen thumbnails" setting
+    const qint64 THUMBNAIL_BUDGET_LOW = 64 * 1024 * 1024;
+    // screens worth of items kept in the scroll direction
+    const int KEEP_AHEAD_PAGES = 2;
+
     QScrollBar *scrollBar;
     QTimeLine *scrollTimeLine;
     QPointF viewportCenter;
     int mThumbnailSize;
     int offscreenPreloadArea = 3000;
 
-    QList<int> rangeSelectionSnapshot;
+    ItemSelection rangeSelectionSnapshot;
     bool rangeSelection; // true if shift is pressed
     bool wayland = false;
 
@@ -115,6 +155,12 @@ protected:
     const int SCROLL_ACCELERATION_THRESHOLD = 50;
 
     const uint LOAD_DELAY = 150;
+    // ms without movement after which the view counts as still
+    const int VELOCITY_TIMEOUT = 100;
+    // ms worth of travel preloaded ahead of the viewport
+    const int PREFETCH_TIME = 400;
+    // px / ms; only cached thumbnails are requested above this
+    const qreal FLING_VELOCITY = 8;
     ScrollDirection lastScrollDirection = SCROLL_FORWARDS;
 
     bool atSceneStart();
@@ -122,9 +168,33 @@ protected:
 
     bool checkRange(int pos);
 
+    // nullptr if the item has no widget right now (virtual mode)
+    ThumbnailWidget *itemWidget(int index);
+    int indexOfWidget(ThumbnailWidget *widget);
+    // every existing widget, bound or not
+    QList<ThumbnailWidget*> allWidgets();
+    QRectF itemSceneRect(int index);
+
+    void updateLiveItems();
+    void layoutLiveItems();
+    void clearLiveItems();
+    void shiftLiveItems(int from, int delta);
+    void remapLiveItems(const QList<int> &newIndex);
+    ThumbnailWidget *acquireWidget(int index);
+    void releaseWidget(ThumbnailWidget *widget);
+
+    // arithmetic layout; places the items in virtual mode and
+    // gives loadVisibleThumbnails() its index ranges in both modes
+    virtual QRectF itemRect(int index) = 0;
+    // items intersecting a scene rect; last < first if there are none
+    virtual void itemRange(const QRectF &rect, int &first, int &last) = 0;
+    virtual QSizeF contentsSize() = 0;
+
     virtual ThumbnailWidget *createThumbnailWidget() = 0;
     virtual void addItemToLayout(ThumbnailWidget* widget, int pos) = 0;
     virtual void removeItemFromLayout(int pos) = 0;
+    // thumbnails were re-sorted, order[newIndex] == oldIndex
+    virtual void reorderLayout(const QList<int> &order) = 0;
     virtual void removeAll() = 0;
     virtual void updateLayout();
     virtual void fitSceneToContents();
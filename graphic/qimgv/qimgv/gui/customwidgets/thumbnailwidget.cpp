@@ -3,6 +3,7 @@
 ThumbnailWidget::ThumbnailWidget(QGraphicsItem *parent) :
     QGraphicsWidget(parent),
     isLoaded(false),
+    isRequested(false),
     thumbnail(nullptr),
     highlighted(false),
     hovered(false),
@@ -13,12 +14,12 @@ ThumbnailWidget::ThumbnailWidget(QGraphicsItem *parent) :
     marginY(2),
     labelSpacing(9),
     textHeight(5),
+    tileDpr(0),
     thumbStyle(THUMB_SIMPLE)
 {
     setAttribute(Qt::WA_OpaquePaintEvent, true);
-    float dpr = qApp->devicePixelRatio();
-    if(trunc(dpr) == dpr) // don't enable for fractional scaling
-        setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+    // no item cache; the static parts are kept in "tile" instead, which
+    // unlike DeviceCoordinateCache survives hover & selection changes
     setAcceptHoverEvents(true);
     font.setBold(false);
     QFontMetrics fm(font);
@@ -28,7 +29,9 @@ ThumbnailWidget::ThumbnailWidget(QGraphicsItem *parent) :
 void ThumbnailWidget::setThumbnailSize(int size) {
     if(mThumbnailSize != size && size > 0) {
         isLoaded = false;
+        isRequested = false;
         mThumbnailSize = size;
+        tile = QPixmap();
         updateBoundingRect();
         updateGeometry();
         updateThumbnailDrawPosition();
@@ -40,12 +43,14 @@ void ThumbnailWidget::setThumbnailSize(int size) {
 
 void ThumbnailWidget::setPadding(int _padding) {
     padding = _padding;
+    tile = QPixmap();
     updateBoundingRect();
 }
 
 void ThumbnailWidget::setMargins(int _marginX, int _marginY) {
     marginX = _marginX;
     marginY = _marginY;
+    tile = QPixmap();
     updateBoundingRect();
 }
 
@@ -56,15 +61,19 @@ int ThumbnailWidget::thumbnailSize() {
 void ThumbnailWidget::reset() {
     if(thumbnail)
         thumbnail.reset();
+    tile = QPixmap();
+    placeholder = QPixmap();
     highlighted = false;
     hovered = false;
     isLoaded = false;
+    isRequested = false;
     update();
 }
 
 void ThumbnailWidget::setThumbStyle(ThumbnailStyle _style) {
     if(thumbStyle != _style) {
         thumbStyle = _style;
+        tile = QPixmap();
         updateBoundingRect();
         updateThumbnailDrawPosition();
         setupTextLayout();
@@ -94,6 +103,9 @@ void ThumbnailWidget::setThumbnail(std::shared_ptr<Thumbnail> _thumbnail) {
     if(_thumbnail) {
         thumbnail = _thumbnail;
         isLoaded = true;
+        isRequested = false;
+        tile = QPixmap();
+        placeholder = QPixmap();
         updateThumbnailDrawPosition();
         setupTextLayout();
         updateBackgroundRect();
@@ -101,10 +113,23 @@ void ThumbnailWidget::setThumbnail(std::shared_ptr<Thumbnail> _thumbnail) {
     }
 }
 
+void ThumbnailWidget::setPlaceholder(const QImage &image) {
+    placeholder = QPixmap::fromImage(image);
+    updateThumbnailDrawPosition();
+    update();
+}
+
 void ThumbnailWidget::unsetThumbnail() {
     if(thumbnail)
         thumbnail.reset();
+    tile = QPixmap();
     isLoaded = false;
+    isRequested = false;
+}
+
+void ThumbnailWidget::invalidateTile() {
+    tile = QPixmap();
+    update();
 }
 
 void ThumbnailWidget::setupTextLayout() {
@@ -183,7 +208,9 @@ void ThumbnailWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
     if(isHighlighted())
         drawHighlight(painter);
 
-    if(!thumbnail) { // not loaded
+    if(!thumbnail && !placeholder.isNull()) {
+        drawPlaceholder(painter);
+    } else if(!thumbnail) { // not loaded
         // todo: recolor once in shrRes
         QPixmap loadingIcon(*shrRes->getPixmap(ShrIcon::SHR_ICON_LOADING, dpr));
         if(isHighlighted())
@@ -192,25 +219,39 @@ void ThumbnailWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
             ImageLib::recolor(loadingIcon, settings->colorScheme().folderview_hc2);
         drawIcon(painter, &loadingIcon);
     } else {
-        if(!thumbnail->pixmap() || thumbnail->pixmap().get()->width() == 0) { // invalid thumb
+        bool valid = thumbnail->pixmap() && thumbnail->pixmap().get()->width() != 0;
+        if(!valid) { // invalid thumb
             QPixmap errorIcon(*shrRes->getPixmap(ShrIcon::SHR_ICON_ERROR, dpr));
             if(isHighlighted())
                 ImageLib::recolor(errorIcon, settings->colorScheme().accent);
             else
                 ImageLib::recolor(errorIcon, settings->colorScheme().folderview_hc2);
             drawIcon(painter, &errorIcon);
-        } else {
-            drawThumbnail(painter, thumbnail->pixmap().get());
-            if(isHovered())
-                drawHoverHighlight(painter);
         }
-        if(thumbStyle != THUMB_SIMPLE)
-            drawLabel(painter);
+        // thumbnail & label don't change with hover / selection
+        if(tile.isNull() || tileDpr != dpr)
+            updateTile(dpr);
+        painter->drawPixmap(QPointF(0, 0), tile);
+        if(valid && isHovered())
+            drawHoverHighlight(painter);
     }
     if(isDropHovered())
         drawDropHover(painter);
 }
 
+void ThumbnailWidget::updateTile(qreal dpr) {
+    tile = QPixmap((boundingRect().size() * dpr).toSize());
+    tile.setDevicePixelRatio(dpr);
+    tile.fill(Qt::transparent);
+    tileDpr = dpr;
+    QPainter tilePainter(&tile);
+    tilePainter.setRenderHints(QPainter::Antialiasing);
+    if(thumbnail->pixmap() && thumbnail->pixmap().get()->width() != 0)
+        drawThumbnail(&tilePainter, thumbnail->pixmap().get());
+    if(thumbStyle != THUMB_SIMPLE)
+        drawLabel(&tilePainter);
+}
+
 void ThumbnailWidget::drawHighlight(QPainter *painter) {
     if(isHighlighted()) {
         auto hints = painter->renderHints();
@@ -312,6 +353,14 @@ void ThumbnailWidget::drawThumbnail(QPainter* painter, const QPixmap *pixmap) {
     painter->drawPixmap(drawRectCentered, *pixmap);
 }
 
+// smooth upscaling of the few pixels is what blurs it
+void ThumbnailWidget::drawPlaceholder(QPainter *painter) {
+    auto hints = painter->renderHints();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->drawPixmap(placeholderRect, placeholder);
+    painter->setRenderHints(hints);
+}
+
 void ThumbnailWidget::drawIcon(QPainter* painter, const QPixmap *pixmap) {
     QPointF drawPosCentered(width()  / 2 - pixmap->width()  / (2 * pixmap->devicePixelRatioF()),
                             height() / 2 - pixmap->height() / (2 * pixmap->devicePixelRatioF()));
@@ -348,20 +397,26 @@ bool ThumbnailWidget::isHovered() {
 
 void ThumbnailWidget::updateThumbnailDrawPosition() {
     if(thumbnail && thumbnail->pixmap()) {
-        QPoint topLeft;
         QSize pixmapSize; // dpr-adjusted size
         if(isLoaded)
             pixmapSize = thumbnail->pixmap()->size() / qApp->devicePixelRatio();
         else
             pixmapSize = thumbnail->pixmap()->size().scaled(mThumbnailSize, mThumbnailSize, Qt::KeepAspectRatio);
-        bool verticalFit = (pixmapSize.height() >= pixmapSize.width());
-        topLeft.setX((width()  - pixmapSize.width())  / 2.0);
-        if(thumbStyle == THUMB_SIMPLE)
-            topLeft.setY((height() - pixmapSize.height()) / 2.0);
-        else if(thumbStyle == THUMB_NORMAL_CENTERED && !verticalFit)
-            topLeft.setY((height() - pixmapSize.height()) / 2.0 - textHeight);
-        else // THUMB_NORMAL - snap thumbnail to the filename label
-            topLeft.setY(padding + marginY + mThumbnailSize - pixmapSize.height());
-        drawRectCentered = QRect(topLeft, pixmapSize);
+        drawRectCentered = thumbnailDrawRect(pixmapSize);
     }
+    if(!placeholder.isNull())
+        placeholderRect = thumbnailDrawRect(placeholder.size().scaled(mThumbnailSize, mThumbnailSize, Qt::KeepAspectRatio));
+}
+
+QRect ThumbnailWidget::thumbnailDrawRect(QSize pixmapSize) {
+    QPoint topLeft;
+    bool verticalFit = (pixmapSize.height() >= pixmapSize.width());
+    topLeft.setX((width()  - pixmapSize.width())  / 2.0);
+    if(thumbStyle == THUMB_SIMPLE)
+        topLeft.setY((height() - pixmapSize.height()) / 2.0);
+    else if(thumbStyle == THUMB_NORMAL_CENTERED && !verticalFit)
+        topLeft.setY((height() - pixmapSize.height()) / 2.0 - textHeight);
+    else // THUMB_NORMAL - snap thumbnail to the filename label
+        topLeft.setY(padding + marginY + mThumbnailSize - pixmapSize.height());
+    return QRect(topLeft, pixmapSize);
 }
@@ -29,7 +29,11 @@ public:
     int type() const override { return Type; }
 
     bool isLoaded;
+    // a thumbnail was requested for it and has not arrived yet
+    bool isRequested;
     void setThumbnail(std::shared_ptr<Thumbnail> _thumbnail);
+    // tiny preview, drawn scaled up until the thumbnail is set
+    void setPlaceholder(const QImage &image);
 
     void setHighlighted(bool mode);
     bool isHighlighted();
@@ -53,11 +57,16 @@ public:
     int thumbnailSize();
     void reset();
     void unsetThumbnail();
+    // repaints the cached tile, e.g. after a color scheme change
+    void invalidateTile();
 
 protected:
     void setupTextLayout();
+    // renders thumbnail & label; hover and selection are painted over it
+    void updateTile(qreal dpr);
     void drawThumbnail(QPainter* painter, const QPixmap *pixmap);
     void drawIcon(QPainter *painter, const QPixmap *pixmap);
+    void drawPlaceholder(QPainter *painter);
     void drawHighlight(QPainter *painter);
     void drawHoverBg(QPainter *painter);
     void drawHoverHighlight(QPainter *painter);
@@ -73,13 +82,17 @@ protected:
     bool isHovered();
     void updateBackgroundRect();
     void updateThumbnailDrawPosition();
+    QRect thumbnailDrawRect(QSize pixmapSize);
 
     std::shared_ptr<Thumbnail> thumbnail;
     bool highlighted, hovered, dropHovered;
     int mThumbnailSize, padding, marginX, marginY, labelSpacing, textHeight;
     QRectF bgRect, mBoundingRect;
     QFont font, fontInfo;
-    QRect drawRectCentered, nameRect, infoRect;
+    QRect drawRectCentered, placeholderRect, nameRect, infoRect;
+    QPixmap placeholder;
+    QPixmap tile;
+    qreal tileDpr;
     void updateBoundingRect();
     ThumbnailStyle thumbStyle;
 };
@@ -53,6 +53,7 @@
 #include <qmath.h>
 
 #include <QWidget>
+#include <QGraphicsItem>
 
 FlowLayout::FlowLayout()
 {
@@ -60,6 +61,7 @@ FlowLayout::FlowLayout()
     m_spacing[1] = 0;
     m_rows = 0;
     m_columns = 0;
+    m_dirtyFrom = 0;
     QSizePolicy sp = sizePolicy();
     sp.setHeightForWidth(true);
     setSizePolicy(sp);
@@ -115,6 +117,7 @@ void FlowLayout::insertItem(int index, QGraphicsLayoutItem *item) {
     if(uint(index) > uint(m_items.count()))
         index = m_items.count();
     m_items.insert(index, item);
+    m_dirtyFrom = qMin(m_dirtyFrom, index);
     invalidate();
 }
 
@@ -131,12 +134,25 @@ QGraphicsLayoutItem *FlowLayout::itemAt(int index) const
 void FlowLayout::removeAt(int index)
 {
     m_items.removeAt(index);
+    m_dirtyFrom = qMin(m_dirtyFrom, index);
     invalidate();
 }
 
 void FlowLayout::clear()
 {
     m_items.clear();
+    m_dirtyFrom = 0;
+    invalidate();
+}
+
+void FlowLayout::reorder(const QList<int> &order)
+{
+    QList<QGraphicsLayoutItem*> items;
+    items.reserve(order.count());
+    for(auto i : order)
+        items << m_items.at(i);
+    m_items.swap(items);
+    m_dirtyFrom = 0;
     invalidate();
 }
 
@@ -153,66 +169,72 @@ void FlowLayout::setSpacing(Qt::Orientations o, qreal spacing)
         m_spacing[1] = spacing;
 }
 
+// Only items from m_dirtyFrom on are placed, unless the grid itself
+// (cell size, column count, centering) has changed. Items that keep
+// their size are just moved.
 void FlowLayout::setGeometry(const QRectF &geom)
 {
     QGraphicsLayout::setGeometry(geom);
-    GridInfo gInfo = doLayout(geom, true);
+    GridInfo gInfo = doLayout(geom);
+    bool resized = gInfo.cellSize != m_grid.cellSize;
+    bool moved = resized || gInfo.origin != m_grid.origin ||
+                 gInfo.maxColumns != m_grid.maxColumns || gInfo.step != m_grid.step;
+    for (int i = moved ? 0 : m_dirtyFrom; i < m_items.count(); ++i) {
+        QRectF rect = cellRect(gInfo, i);
+        QGraphicsItem *graphicsItem = m_items.at(i)->graphicsItem();
+        if (graphicsItem && !resized && i < m_dirtyFrom)
+            graphicsItem->setPos(rect.topLeft());
+        else
+            m_items.at(i)->setGeometry(rect);
+    }
+    m_dirtyFrom = m_items.count();
+    m_grid = gInfo;
     m_columns = gInfo.columns;
     m_rows = gInfo.rows;
 }
 
 // this assumes every item is of the same size
-GridInfo FlowLayout::doLayout(const QRectF &geom, bool applyNewGeometry) const {
-    QElapsedTimer t;
-    t.start();
+GridInfo FlowLayout::doLayout(const QRectF &geom) const {
+    QSizeF itemSize;
+    if(m_items.count())
+        itemSize = m_items.at(0)->effectiveSizeHint(Qt::PreferredSize);
+    return grid(m_items.count(), itemSize, geom.width());
+}
 
+GridInfo FlowLayout::grid(int count, const QSizeF &itemSize, qreal width) const {
     qreal leftMargin, topMargin, rightMargin, bottomMargin;
     getContentsMargins(&leftMargin, &topMargin, &rightMargin, &bottomMargin);
 
-    const qreal maxRowWidth = geom.width() - leftMargin - rightMargin;
-    int centerOffset = 0;
-
-    qreal x = 0;
-    qreal y = 0;
-
-    QSizeF itemSize;
-
-    int columns = m_items.count();
-    int rows = 0;
-    if(columns)
-        rows = 1;
-
-    if(m_items.count()) {
-        // calculate offset for centering
-        const qreal itemWidth = m_items.at(0)->effectiveSizeHint(Qt::PreferredSize).width();
-        int maxCols = static_cast<int>(maxRowWidth / itemWidth);
-        if(m_items.count() >= maxCols)
-            centerOffset = static_cast<int>(fmod(maxRowWidth, itemWidth) / 2);
-        QGraphicsLayoutItem *item = m_items.at(0);
-        itemSize = item->effectiveSizeHint(Qt::PreferredSize);
+    GridInfo gInfo;
+    gInfo.height = topMargin + bottomMargin;
+    gInfo.origin = QPointF(leftMargin, topMargin);
+    if(!count || itemSize.width() <= 0)
+        return gInfo;
+
+    const qreal maxRowWidth = width - leftMargin - rightMargin;
+    gInfo.cellSize = itemSize;
+    // wider than the row: one per row, cut to fit
+    if(gInfo.cellSize.width() > maxRowWidth)
+        gInfo.cellSize.setWidth(qMax(maxRowWidth, 0.0));
+    gInfo.step = gInfo.cellSize + QSizeF(spacing(Qt::Horizontal), spacing(Qt::Vertical));
+    gInfo.maxColumns = qMax(1, static_cast<int>((maxRowWidth + spacing(Qt::Horizontal)) / gInfo.step.width()));
+    gInfo.columns = qMin(count, gInfo.maxColumns);
+    gInfo.rows = (count + gInfo.maxColumns - 1) / gInfo.maxColumns;
+    // center full rows
+    if(count >= gInfo.maxColumns) {
+        qreal rowWidth = gInfo.maxColumns * gInfo.step.width() - spacing(Qt::Horizontal);
+        gInfo.origin.rx() += static_cast<int>(qMax(maxRowWidth - rowWidth, 0.0) / 2);
     }
+    gInfo.height += gInfo.rows * gInfo.step.height() - spacing(Qt::Vertical);
+    return gInfo;
+}
 
-    for (int i = 0; i < m_items.count(); ++i) {
-        qreal next_x;
-        next_x = x + itemSize.width();
-        if (next_x > maxRowWidth) {
-            if(x == 0) {
-                itemSize.setWidth(maxRowWidth);
-            } else {
-                x = 0;
-                next_x = itemSize.width();
-                if(rows == 1)
-                    columns = i;
-                rows++;
-            }
-            y += itemSize.height() + spacing(Qt::Vertical);
-        }
-        if(applyNewGeometry)
-            m_items.at(i)->setGeometry(QRectF(QPointF(leftMargin + x + centerOffset, topMargin + y), itemSize));
-        x = next_x + spacing(Qt::Horizontal);
-    }
-    //qDebug() << "elapsed: " << t.elapsed();
-    return GridInfo(columns, rows, topMargin + y + itemSize.height() + bottomMargin);
+QRectF FlowLayout::cellRect(const GridInfo &grid, int index) {
+    if(grid.maxColumns <= 0)
+        return QRectF(grid.origin, grid.cellSize);
+    QPointF pos(grid.origin.x() + (index % grid.maxColumns) * grid.step.width(),
+                grid.origin.y() + (index / grid.maxColumns) * grid.step.height());
+    return QRectF(pos, grid.cellSize);
 }
 
 QSizeF FlowLayout::minSize(const QSizeF &constraint) const
@@ -221,14 +243,13 @@ QSizeF FlowLayout::minSize(const QSizeF &constraint) const
     qreal left, top, right, bottom;
     getContentsMargins(&left, &top, &right, &bottom);
     if (constraint.width() >= 0) {   // height for width
-        const qreal height = doLayout(QRectF(QPointF(0,0), constraint), false).height;
+        const qreal height = doLayout(QRectF(QPointF(0,0), constraint)).height;
         size = QSizeF(constraint.width(), height);
     } else if (constraint.height() >= 0) {  // width for height?
         // not supported
     } else {
-        QGraphicsLayoutItem *item;
-        foreach (item, m_items)
-            size = size.expandedTo(item->effectiveSizeHint(Qt::MinimumSize));
+        if(m_items.count())
+            size = m_items.at(0)->effectiveSizeHint(Qt::MinimumSize);
         size += QSize(left + right, top + bottom);
     }
     return size;
@@ -239,15 +260,12 @@ QSizeF FlowLayout::prefSize() const
     qreal left, right;
     getContentsMargins(&left, 0, &right, 0);
 
-    QGraphicsLayoutItem *item;
     qreal maxh = 0;
     qreal totalWidth = 0;
-    foreach (item, m_items) {
-        if (totalWidth > 0)
-            totalWidth += spacing(Qt::Horizontal);
-        QSizeF pref = item->effectiveSizeHint(Qt::PreferredSize);
-        totalWidth += pref.width();
-        maxh = qMax(maxh, pref.height());
+    if (m_items.count()) {
+        QSizeF pref = m_items.at(0)->effectiveSizeHint(Qt::PreferredSize);
+        totalWidth = m_items.count() * (pref.width() + spacing(Qt::Horizontal)) - spacing(Qt::Horizontal);
+        maxh = pref.height();
     }
     maxh += spacing(Qt::Vertical);
 
@@ -259,17 +277,12 @@ QSizeF FlowLayout::prefSize() const
 
 QSizeF FlowLayout::maxSize() const
 {
-    QGraphicsLayoutItem *item;
     qreal totalWidth = 0;
     qreal totalHeight = 0;
-    foreach (item, m_items) {
-        if (totalWidth > 0)
-            totalWidth += spacing(Qt::Horizontal);
-        if (totalHeight > 0)
-            totalHeight += spacing(Qt::Vertical);
-        QSizeF pref = item->effectiveSizeHint(Qt::PreferredSize);
-        totalWidth += pref.width();
-        totalHeight += pref.height();
+    if (m_items.count()) {
+        QSizeF pref = m_items.at(0)->effectiveSizeHint(Qt::PreferredSize);
+        totalWidth = m_items.count() * (pref.width() + spacing(Qt::Horizontal)) - spacing(Qt::Horizontal);
+        totalHeight = m_items.count() * (pref.height() + spacing(Qt::Vertical)) - spacing(Qt::Vertical);
     }
 
     qreal left, top, right, bottom;
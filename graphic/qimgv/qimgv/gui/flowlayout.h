@@ -55,13 +55,14 @@
 #include <QElapsedTimer>
 
 struct GridInfo {
-    GridInfo(int _columns, int _rows, qreal _height) {
-        columns = _columns;
-        rows = _rows;
-        height = _height;
-    }
+    GridInfo() : columns(0), rows(0), maxColumns(0), height(0) {}
     int columns, rows;
+    // columns in a full row
+    int maxColumns;
     qreal height;
+    // cell n is at origin + (n % maxColumns, n / maxColumns) * step
+    QPointF origin;
+    QSizeF cellSize, step;
 };
 
 class FlowLayout : public QGraphicsLayout
@@ -85,15 +86,21 @@ public:
     int rows();
     int columns();
     void clear();
+    // order[newIndex] == oldIndex
+    void reorder(const QList<int> &order);
 
     int columnOf(int index);
     bool sameRow(int one, int two);
 
+    // layout math for count items of itemSize, also usable without any items
+    GridInfo grid(int count, const QSizeF &itemSize, qreal width) const;
+    static QRectF cellRect(const GridInfo &grid, int index);
+
 protected:
     QSizeF sizeHint(Qt::SizeHint which, const QSizeF &constraint = QSizeF()) const override;
 
 private:
-    GridInfo doLayout(const QRectF &geom, bool applyNewGeometry) const;
+    GridInfo doLayout(const QRectF &geom) const;
     QSizeF minSize(const QSizeF &constraint) const;
     QSizeF prefSize() const;
     QSizeF maxSize() const;
@@ -101,4 +108,8 @@ private:
     QList<QGraphicsLayoutItem*> m_items;
     qreal m_spacing[2];
     int m_rows, m_columns;
+    // grid the items were last placed on
+    GridInfo m_grid;
+    // items from here on were inserted / shifted since the last setGeometry()
+    int m_dirtyFrom;
 };
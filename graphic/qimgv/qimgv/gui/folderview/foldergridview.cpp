@@ -20,6 +20,9 @@ FolderGridView::FolderGridView(QWidget *parent)
 
     connect(settings, &Settings::settingsChanged, [this]() {
         this->scene.setBackgroundBrush(settings->colorScheme().folderview);
+        // label colors are baked into the tiles
+        for(auto widget : allWidgets())
+            widget->invalidateTile();
     });
 
     setupLayout();
@@ -32,7 +35,7 @@ void FolderGridView::dropEvent(QDropEvent *event) {
     ThumbnailWidget *item = dynamic_cast<ThumbnailWidget*>(itemAt(event->pos()));
     int index = -1;
     if(item) {
-        index = thumbnails.indexOf(item);
+        index = indexOfWidget(item);
         item->setDropHovered(false);
     }
     emit droppedInto(event->mimeData(), event->source(), index);
@@ -47,26 +50,25 @@ void FolderGridView::dragMoveEvent(QDragMoveEvent *event) {
     ThumbnailWidget *item = dynamic_cast<ThumbnailWidget*>(itemAt(event->pos()));
     int index = -1;
     if(item)
-        index = thumbnails.indexOf(item);
+        index = indexOfWidget(item);
     // unselect previous
-    if(index != lastDragTarget && checkRange(lastDragTarget))
-        thumbnails.at(lastDragTarget)->setDropHovered(false);
+    if(index != lastDragTarget) {
+        if(auto target = itemWidget(lastDragTarget))
+            target->setDropHovered(false);
+    }
     emit draggedOver(index);
     lastDragTarget = index;
 }
 
 void FolderGridView::dragLeaveEvent(QDragLeaveEvent *event) {
     event->accept();
-    if(lastDragTarget < 0 || lastDragTarget >= thumbnails.count())
-        return;
-    thumbnails.at(lastDragTarget)->setDropHovered(false);
+    if(auto target = itemWidget(lastDragTarget))
+        target->setDropHovered(false);
 }
 
 void FolderGridView::setDragHover(int index) {
-    if(!checkRange(index))
-        return;
-    auto item = thumbnails.at(index);
-    item->setDropHovered(true);
+    if(auto item = itemWidget(index))
+        item->setDropHovered(true);
 }
 
 void FolderGridView::onitemSelected() {
@@ -74,10 +76,9 @@ void FolderGridView::onitemSelected() {
 }
 
 void FolderGridView::updateScrollbarIndicator() {
-    if(!thumbnails.count() || !selection().count())
+    if(!itemCount() || !selection().count())
         return;
-    ThumbnailWidget *thumb = thumbnails.at(lastSelected());
-    qreal itemCenter = (thumb->pos().y() + (thumb->height() / 2)) / scene.height();
+    qreal itemCenter = itemSceneRect(lastSelected()).center().y() / scene.height();
     indicator = QRect(2, scrollBar->height() * itemCenter - indicatorSize, scrollBar->width() - 4, indicatorSize);
 }
 
@@ -95,40 +96,38 @@ void FolderGridView::hide() {
 
 void FolderGridView::setShowLabels(bool mode) {
     ThumbnailStyle style = mode ? THUMB_NORMAL : THUMB_SIMPLE;
-    for(int i = 0; i < thumbnails.count(); i++)
-        thumbnails.at(i)->setThumbStyle(style);
+    for(auto widget : allWidgets())
+        widget->setThumbStyle(style);
+    cellSize = QSizeF();
     updateLayout();
     fitSceneToContents();
     focusOnSelection();
 }
 
 void FolderGridView::focusOnSelection() {
-    if(!thumbnails.count() || lastSelected() == -1)
+    if(!itemCount() || lastSelected() == -1)
         return;
-    ThumbnailWidget *thumb = thumbnails.at(lastSelected());
-    ensureVisible(thumb, 0, 0);
+    ensureVisible(itemSceneRect(lastSelected()), 0, 0);
 }
 
 void FolderGridView::selectAll() {
-    QList<int> list;
-    for(int i = 0; i < thumbnails.count(); i++)
-        list << i;
-    // preserve last selected index by putting it at the end of a new selection
-    // this is simpler but it changes selection order a bit
-    if(lastSelected() != -1) {
-        // in this case list is sorted so no need to indexOf()
-        list.move(lastSelected(), list.count() - 1);
-    }
-    select(list);
+    if(!itemCount())
+        return;
+    ItemSelection all;
+    all.addRange(0, itemCount() - 1);
+    // keep the last selected index
+    if(lastSelected() != -1)
+        all.add(lastSelected());
+    select(all);
 }
 
 void FolderGridView::selectAbove() {
-    if(!thumbnails.count() || lastSelected() == -1 || flowLayout->sameRow(0, lastSelected()))
+    if(!itemCount() || lastSelected() == -1 || sameRow(0, lastSelected()))
         return;
     int newIndex;
-    newIndex = flowLayout->itemAbove(lastSelected());
+    newIndex = itemAbove(lastSelected());
     if(shiftedCol >= 0) {
-        int diff = shiftedCol - flowLayout->columnOf(lastSelected());
+        int diff = shiftedCol - columnOf(lastSelected());
         newIndex += diff;
         shiftedCol = -1;
     }
@@ -142,14 +141,14 @@ void FolderGridView::selectAbove() {
 }
 
 void FolderGridView::selectBelow() {
-    if(!thumbnails.count() || lastSelected() == -1 || flowLayout->sameRow(lastSelected(), thumbnails.count() - 1))
+    if(!itemCount() || lastSelected() == -1 || sameRow(lastSelected(), itemCount() - 1))
         return;
     shiftedCol = -1;
-    int newIndex = flowLayout->itemBelow(lastSelected());
+    int newIndex = itemBelow(lastSelected());
     if(!checkRange(newIndex))
-        newIndex = thumbnails.count() - 1;
-    if(flowLayout->columnOf(newIndex) != flowLayout->columnOf(lastSelected()))
-        shiftedCol = flowLayout->columnOf(lastSelected());
+        newIndex = itemCount() - 1;
+    if(columnOf(newIndex) != columnOf(lastSelected()))
+        shiftedCol = columnOf(lastSelected());
     if(rangeSelection)
         addSelectionRange(newIndex);
     else
@@ -158,16 +157,16 @@ void FolderGridView::selectBelow() {
 }
 
 void FolderGridView::selectNext() {
-    if(!thumbnails.count() || lastSelected() == thumbnails.count() - 1)
+    if(!itemCount() || lastSelected() == itemCount() - 1)
         return;
-    if(!rangeSelection && lastSelected() == thumbnails.count() - 1) {
+    if(!rangeSelection && lastSelected() == itemCount() - 1) {
         select(lastSelected());
         return;
     }
     shiftedCol = -1;
     int newIndex = lastSelected() + 1;
     if(!checkRange(newIndex))
-        newIndex = thumbnails.count() - 1;
+        newIndex = itemCount() - 1;
     if(rangeSelection)
         addSelectionRange(newIndex);
     else
@@ -176,7 +175,7 @@ void FolderGridView::selectNext() {
 }
 
 void FolderGridView::selectPrev() {
-    if(!thumbnails.count() || lastSelected() == 0)
+    if(!itemCount() || lastSelected() == 0)
         return;
     shiftedCol = -1;
     int newIndex = lastSelected() - 1;
@@ -190,18 +189,18 @@ void FolderGridView::selectPrev() {
 }
 
 void FolderGridView::pageUp() {
-    if(!thumbnails.count() || lastSelected() == -1 || flowLayout->sameRow(0, lastSelected()))
+    if(!itemCount() || lastSelected() == -1 || sameRow(0, lastSelected()))
         return;
     int newIndex = lastSelected();
     int tmp;
     // 4 rows up
     for(int i = 0; i < 4; i++) {
-        tmp = flowLayout->itemAbove(newIndex);
+        tmp = itemAbove(newIndex);
         if(checkRange(tmp))
             newIndex = tmp;
     }
     if(shiftedCol >= 0) {
-        int diff = shiftedCol - flowLayout->columnOf(newIndex);
+        int diff = shiftedCol - columnOf(newIndex);
         newIndex += diff;
         shiftedCol = -1;
     }
@@ -213,19 +212,19 @@ void FolderGridView::pageUp() {
 }
 
 void FolderGridView::pageDown() {
-    if(!thumbnails.count() || lastSelected() == -1 || flowLayout->sameRow(lastSelected(), thumbnails.count() - 1))
+    if(!itemCount() || lastSelected() == -1 || sameRow(lastSelected(), itemCount() - 1))
         return;
     shiftedCol = -1;
     int newIndex = lastSelected();
     int tmp;
     // 4 rows down
     for(int i = 0; i < 4; i++) {
-        tmp = flowLayout->itemBelow(newIndex);
+        tmp = itemBelow(newIndex);
         if(checkRange(tmp))
             newIndex = tmp;
     }
-    if(flowLayout->columnOf(newIndex) != flowLayout->columnOf(lastSelected()))
-        shiftedCol = flowLayout->columnOf(lastSelected());
+    if(columnOf(newIndex) != columnOf(lastSelected()))
+        shiftedCol = columnOf(lastSelected());
     if(rangeSelection)
         addSelectionRange(newIndex);
     else
@@ -234,7 +233,7 @@ void FolderGridView::pageDown() {
 }
 
 void FolderGridView::selectFirst() {
-    if(!thumbnails.count())
+    if(!itemCount())
         return;
     shiftedCol = -1;
     if(rangeSelection)
@@ -245,13 +244,13 @@ void FolderGridView::selectFirst() {
 }
 
 void FolderGridView::selectLast() {
-    if(!thumbnails.count())
+    if(!itemCount())
         return;
     shiftedCol = -1;
     if(rangeSelection)
-        addSelectionRange(thumbnails.count() - 1);
+        addSelectionRange(itemCount() - 1);
     else
-        select(thumbnails.count() - 1);
+        select(itemCount() - 1);
     scrollToCurrent();
 }
 
@@ -263,8 +262,7 @@ void FolderGridView::scrollToCurrent() {
 void FolderGridView::focusOn(int index) {
     if(!checkRange(index))
         return;
-    ThumbnailWidget *thumb = thumbnails.at(index);
-    ensureVisible(thumb, 0, 0);
+    ensureVisible(itemSceneRect(index), 0, 0);
     loadVisibleThumbnailsDelayed();
 }
 
@@ -297,6 +295,10 @@ void FolderGridView::removeItemFromLayout(int pos) {
     flowLayout->removeAt(pos);
 }
 
+void FolderGridView::reorderLayout(const QList<int> &order) {
+    flowLayout->reorder(order);
+}
+
 void FolderGridView::removeAll() {
     flowLayout->clear();
     qDeleteAll(thumbnails);
@@ -305,10 +307,83 @@ void FolderGridView::removeAll() {
 
 void FolderGridView::updateLayout() {
     shiftedCol = -1;
+    updateCellSize();
+    if(mVirtualMode) {
+        layoutLiveItems();
+        return;
+    }
     flowLayout->invalidate();
     flowLayout->activate();
 }
 
+// only changes with thumbnail size or style; reset by their setters
+void FolderGridView::updateCellSize() {
+    if(cellSize.isValid())
+        return;
+    std::unique_ptr<ThumbnailWidget> sample(createThumbnailWidget());
+    cellSize = sample->effectiveSizeHint(Qt::PreferredSize);
+}
+
+int FolderGridView::gridColumns() {
+    return mVirtualMode ? grid().columns : flowLayout->columns();
+}
+
+// what FlowLayout would make of the current items
+GridInfo FolderGridView::grid() {
+    return flowLayout->grid(itemCount(), cellSize, holderWidget.size().width());
+}
+
+bool FolderGridView::sameRow(int one, int two) {
+    int columns = gridColumns();
+    return columns && (one / columns == two / columns);
+}
+
+int FolderGridView::columnOf(int index) {
+    if(!checkRange(index))
+        return -1;
+    return index % gridColumns();
+}
+
+// returns the index of item above / below
+int FolderGridView::itemAbove(int index) {
+    if(!checkRange(index))
+        return -1;
+    int indexAbove = index - gridColumns();
+    return (indexAbove >= 0) ? indexAbove : index;
+}
+
+int FolderGridView::itemBelow(int index) {
+    if(!checkRange(index))
+        return -1;
+    if(sameRow(index, itemCount() - 1))
+        return index;
+    int indexBelow = index + gridColumns();
+    return (indexBelow < itemCount()) ? indexBelow : itemCount() - 1;
+}
+
+QRectF FolderGridView::itemRect(int index) {
+    return FlowLayout::cellRect(grid(), index);
+}
+
+void FolderGridView::itemRange(const QRectF &rect, int &first, int &last) {
+    first = 0;
+    last = -1;
+    GridInfo gInfo = grid();
+    if(!gInfo.rows || gInfo.step.height() <= 0)
+        return;
+    qreal top = gInfo.origin.y();
+    int firstRow = qMax(0, static_cast<int>(floor((rect.top() - top) / gInfo.step.height())));
+    int lastRow = qMin(gInfo.rows - 1, static_cast<int>(floor((rect.bottom() - top) / gInfo.step.height())));
+    if(lastRow < firstRow)
+        return;
+    first = firstRow * gInfo.maxColumns;
+    last = qMin(itemCount() - 1, (lastRow + 1) * gInfo.maxColumns - 1);
+}
+
+QSizeF FolderGridView::contentsSize() {
+    return QSizeF(holderWidget.size().width(), grid().height);
+}
+
 // block native tab-switching so we can use it in shortcuts
 bool FolderGridView::focusNextPrevChild(bool) {
     return false;
@@ -390,13 +465,13 @@ void FolderGridView::zoomOut() {
 void FolderGridView::setThumbnailSize(int newSize) {
     newSize = clamp(newSize, THUMBNAIL_SIZE_MIN, THUMBNAIL_SIZE_MAX);
     mThumbnailSize = newSize;
-    for(int i = 0; i < thumbnails.count(); i++) {
-        thumbnails.at(i)->setThumbnailSize(newSize);
-    }
+    for(auto widget : allWidgets())
+        widget->setThumbnailSize(newSize);
+    cellSize = QSizeF();
     updateLayout();
     fitSceneToContents();
     if(lastSelected() != -1)
-        ensureVisible(thumbnails.at(lastSelected()), 0, 40);
+        ensureVisible(itemSceneRect(lastSelected()), 0, 40);
     emit thumbnailSizeChanged(mThumbnailSize);
     loadVisibleThumbnails();
 }
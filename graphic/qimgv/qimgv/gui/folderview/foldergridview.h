@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QGraphicsWidget>
+#include <cmath>
+#include <memory>
 
 #include "gui/customwidgets/thumbnailview.h"
 #include "gui/customwidgets/thumbnailwidget.h"
@@ -43,6 +45,16 @@ private:
     FlowLayout *flowLayout;
     QGraphicsWidget holderWidget;
     int shiftedCol;
+    // virtual mode places items itself, the same way FlowLayout would
+    // invalid until computed
+    QSizeF cellSize;
+    void updateCellSize();
+    int gridColumns();
+    GridInfo grid();
+    bool sameRow(int one, int two);
+    int columnOf(int index);
+    int itemAbove(int index);
+    int itemBelow(int index);
     void scrollToCurrent();
     int lastDragTarget = -1;
 
@@ -54,11 +66,15 @@ protected:
     virtual void updateScrollbarIndicator() override;
     void addItemToLayout(ThumbnailWidget *widget, int pos) override;
     void removeItemFromLayout(int pos) override;
+    void reorderLayout(const QList<int> &order) override;
     void removeAll() override;
     void setupLayout();
     ThumbnailWidget *createThumbnailWidget() override;
     void updateLayout() override;
     virtual void fitSceneToContents() override;
+    QRectF itemRect(int index) override;
+    void itemRange(const QRectF &rect, int &first, int &last) override;
+    QSizeF contentsSize() override;
 
     void keyPressEvent(QKeyEvent *event) override;
     void wheelEvent(QWheelEvent *event) override;    
@@ -244,7 +244,11 @@ void FolderView::setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) {
     ui->thumbnailGrid->setThumbnail(pos, thumb);
 }
 
-void FolderView::select(QList<int> indices) {
+void FolderView::setPlaceholder(int pos, const QImage &image) {
+    ui->thumbnailGrid->setPlaceholder(pos, image);
+}
+
+void FolderView::select(const ItemSelection &indices) {
     ui->thumbnailGrid->select(indices);
 }
 
@@ -252,7 +256,7 @@ void FolderView::select(int index) {
     ui->thumbnailGrid->select(index);
 }
 
-QList<int> FolderView::selection() {
+const ItemSelection &FolderView::selection() {
     return ui->thumbnailGrid->selection();
 }
 
@@ -342,14 +346,26 @@ void FolderView::insertItem(int index) {
     ui->thumbnailGrid->insertItem(index);
 }
 
+void FolderView::insertItems(QList<int> indices) {
+    ui->thumbnailGrid->insertItems(indices);
+}
+
 void FolderView::removeItem(int index) {
     ui->thumbnailGrid->removeItem(index);
 }
 
+void FolderView::removeItems(QList<int> indices) {
+    ui->thumbnailGrid->removeItems(indices);
+}
+
 void FolderView::reloadItem(int index) {
     ui->thumbnailGrid->reloadItem(index);
 }
 
+void FolderView::reorderItems(QList<int> order) {
+    ui->thumbnailGrid->reorderItems(order);
+}
+
 void FolderView::setDragHover(int index) {
     ui->thumbnailGrid->setDragHover(index);
 }
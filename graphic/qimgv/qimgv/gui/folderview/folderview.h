@@ -31,15 +31,19 @@ public slots:
     void hide();
     virtual void populate(int) override;
     virtual void setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) override;
-    virtual void select(QList<int>) override;
+    virtual void setPlaceholder(int pos, const QImage &image) override;
+    virtual void select(const ItemSelection &) override;
     virtual void select(int) override;
-    virtual QList<int> selection() override;
+    virtual const ItemSelection &selection() override;
     virtual void focusOn(int) override;
     virtual void focusOnSelection() override;
     virtual void setDirectoryPath(QString path) override;
     virtual void insertItem(int index) override;
+    virtual void insertItems(QList<int> indices) override;
     virtual void removeItem(int index) override;
+    virtual void removeItems(QList<int> indices) override;
     virtual void reloadItem(int index) override;
+    virtual void reorderItems(QList<int> order) override;
     virtual void setDragHover(int) override;
     void addItem();
     void onFullscreenModeChanged(bool mode);
@@ -58,7 +62,7 @@ protected slots:
 
 signals:
     void itemActivated(int) override;
-    void thumbnailsRequested(QList<int>, int, bool, bool) override;
+    void thumbnailsRequested(QList<int>, int, bool, bool, bool) override;
     void draggedOut() override;
     void draggedToBookmarks(QList<int>) override;
     void sortingSelected(SortingMode);
@@ -63,7 +63,12 @@ void FolderViewProxy::setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) {
     }
 }
 
-void FolderViewProxy::select(QList<int> indices) {
+void FolderViewProxy::setPlaceholder(int pos, const QImage &image) {
+    if(folderView)
+        folderView->setPlaceholder(pos, image);
+}
+
+void FolderViewProxy::select(const ItemSelection &indices) {
     if(folderView) {
         folderView->select(indices);
     } else {
@@ -76,11 +81,11 @@ void FolderViewProxy::select(int index) {
         folderView->select(index);
     } else {
         stateBuf.selection.clear();
-        stateBuf.selection << index;
+        stateBuf.selection.add(index);
     }
 }
 
-QList<int> FolderViewProxy::selection() {
+const ItemSelection &FolderViewProxy::selection() {
     if(folderView) {
         return folderView->selection();
     } else {
@@ -116,18 +121,31 @@ void FolderViewProxy::insertItem(int index) {
     }
 }
 
+void FolderViewProxy::insertItems(QList<int> indices) {
+    if(folderView) {
+        folderView->insertItems(indices);
+    } else {
+        stateBuf.itemCount += indices.count();
+    }
+}
+
 void FolderViewProxy::removeItem(int index) {
     if(folderView) {
         folderView->removeItem(index);
     } else {
         stateBuf.itemCount--;
-        stateBuf.selection.removeAll(index);
-        for(int i=0; i < stateBuf.selection.count(); i++) {
-            if(stateBuf.selection[i] > index)
-                stateBuf.selection[i]--;
-        }
-        if(!stateBuf.selection.count())
-            stateBuf.selection << ((index >= stateBuf.itemCount) ? stateBuf.itemCount - 1 : index);
+        stateBuf.selection.removeAt(index);
+        if(stateBuf.selection.isEmpty())
+            stateBuf.selection.add((index >= stateBuf.itemCount) ? stateBuf.itemCount - 1 : index);
+    }
+}
+
+void FolderViewProxy::removeItems(QList<int> indices) {
+    if(folderView) {
+        folderView->removeItems(indices);
+    } else {
+        for(int i = indices.count() - 1; i >= 0; i--)
+            removeItem(indices.at(i));
     }
 }
 
@@ -136,6 +154,13 @@ void FolderViewProxy::reloadItem(int index) {
         folderView->reloadItem(index);
 }
 
+void FolderViewProxy::reorderItems(QList<int> order) {
+    if(folderView)
+        folderView->reorderItems(order);
+    else
+        stateBuf.selection.reorder(order);
+}
+
 void FolderViewProxy::setDragHover(int index) {
     if(folderView)
         folderView->setDragHover(index);
@@ -5,7 +5,7 @@
 
 struct FolderViewStateBuffer {
     QString directory;
-    QList<int> selection;
+    ItemSelection selection;
     int itemCount = 0;
     SortingMode sortingMode;
     bool fullscreenMode;
@@ -21,15 +21,19 @@ public:
 public slots:
     virtual void populate(int) override;
     virtual void setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) override;
-    virtual void select(QList<int>) override;
+    virtual void setPlaceholder(int pos, const QImage &image) override;
+    virtual void select(const ItemSelection &) override;
     virtual void select(int) override;
-    virtual QList<int> selection() override;
+    virtual const ItemSelection &selection() override;
     virtual void focusOn(int) override;
     virtual void focusOnSelection() override;
     virtual void setDirectoryPath(QString path) override;
     virtual void insertItem(int index) override;
+    virtual void insertItems(QList<int> indices) override;
     virtual void removeItem(int index) override;
+    virtual void removeItems(QList<int> indices) override;
     virtual void reloadItem(int index) override;
+    virtual void reorderItems(QList<int> order) override;
     virtual void setDragHover(int) override;
     void addItem();
     void onFullscreenModeChanged(bool mode);
@@ -40,7 +44,7 @@ protected:
 
 signals:
     void itemActivated(int) override;
-    void thumbnailsRequested(QList<int>, int, bool, bool) override;
+    void thumbnailsRequested(QList<int>, int, bool, bool, bool) override;
     void draggedOut() override;
     void draggedToBookmarks(QList<int>) override;
     void sortingSelected(SortingMode);
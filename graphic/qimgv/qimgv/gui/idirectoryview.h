@@ -3,9 +3,11 @@
 #include <QtPlugin>
 #include <QList>
 #include <memory>
+#include "utils/itemselection.h"
 
 class Thumbnail;
 class QString;
+class QImage;
 class QMimeData;
 
 class IDirectoryView {
@@ -14,20 +16,26 @@ public:
 
     virtual void populate(int) = 0;
     virtual void setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) = 0;
-    virtual void select(QList<int>) = 0;
+    // shown until the thumbnail arrives
+    virtual void setPlaceholder(int pos, const QImage &image) = 0;
+    virtual void select(const ItemSelection &) = 0;
     virtual void select(int) = 0;
     virtual void focusOn(int) = 0;
     virtual void focusOnSelection() = 0;
-    virtual QList<int> selection() = 0;
+    virtual const ItemSelection &selection() = 0;
     virtual void setDirectoryPath(QString path) = 0;
     virtual void insertItem(int index) = 0;
+    virtual void insertItems(QList<int> indices) = 0;
     virtual void removeItem(int index) = 0;
+    virtual void removeItems(QList<int> indices) = 0;
     virtual void reloadItem(int index) = 0;
+    // order[newIndex] == oldIndex
+    virtual void reorderItems(QList<int> order) = 0;
     virtual void setDragHover(int index) = 0;
 
 //signals
     virtual void itemActivated(int) = 0;
-    virtual void thumbnailsRequested(QList<int>, int, bool, bool) = 0;
+    virtual void thumbnailsRequested(QList<int>, int, bool, bool, bool) = 0;
     virtual void draggedOut() = 0;
     virtual void draggedToBookmarks(QList<int>) = 0;
     virtual void draggedOver(int) = 0;
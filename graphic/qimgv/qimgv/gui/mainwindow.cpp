@@ -247,6 +247,11 @@ void MW::showImage(std::unique_ptr<QPixmap> pixmap) {
     updateCropPanelData();
 }
 
+void MW::showPreview(std::unique_ptr<QPixmap> pixmap) {
+    viewerWidget->showImage(std::move(pixmap));
+    updateCropPanelData();
+}
+
 void MW::showAnimation(std::shared_ptr<QMovie> movie) {
     if(settings->autoResizeWindow())
         preShowResize(movie->frameRect().size());
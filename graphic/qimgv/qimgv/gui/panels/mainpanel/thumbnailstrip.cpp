@@ -10,7 +10,7 @@ ThumbnailStrip::ThumbnailStrip(QWidget *parent) : ThumbnailView(Qt::Horizontal,
 }
 
 void ThumbnailStrip::updateScrollbarIndicator() {
-    if(!thumbnails.count() || lastSelected() == -1)
+    if(!itemCount() || lastSelected() == -1)
         return;
     qreal itemCenter = (qreal)(lastSelected() + 0.5) / itemCount();
     if(scrollBar->orientation() == Qt::Horizontal)
@@ -59,6 +59,11 @@ void ThumbnailStrip::removeItemFromLayout(int pos) {
     }
 }
 
+void ThumbnailStrip::reorderLayout(const QList<int> &order) {
+    Q_UNUSED(order)
+    updateThumbnailPositions();
+}
+
 void ThumbnailStrip::removeAll() {
     scene.clear(); // also calls delete on all items
     thumbnails.clear();
@@ -91,19 +96,19 @@ void ThumbnailStrip::updateThumbnailPositions(int start, int end) {
 void ThumbnailStrip::focusOn(int index) {
     if(!checkRange(index))
         return;
-    auto th = thumbnails.at(index);
+    QRectF th = itemSceneRect(index);
     if(settings->panelCenterSelection()) {
-        QGraphicsView::centerOn(th->sceneBoundingRect().center());
+        QGraphicsView::centerOn(th.center());
     } else {
         // partially show the next thumb if possible
         if(orientation() == Qt::Vertical) {
-            if(height() > th->height() * 2)
-                ensureVisible(th, 0, th->height()/2);
+            if(height() > th.height() * 2)
+                ensureVisible(th, 0, static_cast<int>(th.height() / 2));
             else
                 ensureVisible(th, 0, 0);
         } else {
-            if(width() > th->width() * 2)
-                ensureVisible(th, th->width() / 2, 0);
+            if(width() > th.width() * 2)
+                ensureVisible(th, static_cast<int>(th.width() / 2), 0);
             else
                 ensureVisible(th, 0, 0);
         }
@@ -135,30 +140,62 @@ void ThumbnailStrip::readSettings() {
         thumbMarginY = 2;
     }
 
+    updateCellSize();
     // apply style, size & reposition
-    for(int i = 0; i < thumbnails.count(); i++) {
-        thumbnails.at(i)->setPadding(thumbPadding);
-        thumbnails.at(i)->setMargins(thumbMarginX, thumbMarginY);
-        thumbnails.at(i)->setThumbStyle(mCurrentStyle);
-        thumbnails.at(i)->setThumbnailSize(mThumbnailSize);
+    for(auto widget : allWidgets()) {
+        widget->setPadding(thumbPadding);
+        widget->setMargins(thumbMarginX, thumbMarginY);
+        widget->setThumbStyle(mCurrentStyle);
+        widget->setThumbnailSize(mThumbnailSize);
     }
-    updateThumbnailPositions(0, thumbnails.count() - 1);
+    if(!mVirtualMode)
+        updateThumbnailPositions(0, thumbnails.count() - 1);
     fitSceneToContents();
     setCropThumbnails(settings->squareThumbnails());
     focusOn(lastSelected());
 }
 
 QSize ThumbnailStrip::itemSize() {
-    if(!thumbnails.count()) {
-        ThumbnailWidget w;
-        w.setPadding(thumbPadding);
-        w.setMargins(thumbMarginX, thumbMarginY);
-        w.setThumbStyle(mCurrentStyle);
-        w.setThumbnailSize(mThumbnailSize);
-        return w.boundingRect().size().toSize();
-    } else {
+    if(!thumbnails.count())
+        return cellSize.toSize();
+    else
         return thumbnails.at(0)->boundingRect().size().toSize();
-    }
+}
+
+void ThumbnailStrip::updateCellSize() {
+    ThumbnailWidget w;
+    w.setPadding(thumbPadding);
+    w.setMargins(thumbMarginX, thumbMarginY);
+    w.setThumbStyle(mCurrentStyle);
+    w.setThumbnailSize(mThumbnailSize);
+    cellSize = w.boundingRect().size();
+}
+
+// same as updateThumbnailPositions(), items are placed back to back
+QRectF ThumbnailStrip::itemRect(int index) {
+    if(orientation() == Qt::Horizontal)
+        return QRectF(QPointF(index * std::floor(cellSize.width()), 0), cellSize);
+    else
+        return QRectF(QPointF(0, index * std::floor(cellSize.height())), cellSize);
+}
+
+void ThumbnailStrip::itemRange(const QRectF &rect, int &first, int &last) {
+    first = 0;
+    last = -1;
+    qreal step = std::floor((orientation() == Qt::Horizontal) ? cellSize.width() : cellSize.height());
+    if(!itemCount() || step <= 0)
+        return;
+    qreal from = (orientation() == Qt::Horizontal) ? rect.left() : rect.top();
+    qreal to = (orientation() == Qt::Horizontal) ? rect.right() : rect.bottom();
+    first = qMax(0, static_cast<int>(std::floor(from / step)));
+    last = qMin(itemCount() - 1, static_cast<int>(std::floor(to / step)));
+}
+
+QSizeF ThumbnailStrip::contentsSize() {
+    if(orientation() == Qt::Horizontal)
+        return QSizeF(itemCount() * std::floor(cellSize.width()), cellSize.height());
+    else
+        return QSizeF(cellSize.width(), itemCount() * std::floor(cellSize.height()));
 }
 
 void ThumbnailStrip::resizeEvent(QResizeEvent *event) {
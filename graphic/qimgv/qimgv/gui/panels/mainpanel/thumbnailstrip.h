@@ -29,7 +29,10 @@ private:
     void updateThumbnailPositions(int start, int end);
     void updateThumbnailPositions();
     void setupLayout();
+    void updateCellSize();
     ThumbnailStyle mCurrentStyle;
+    // size of a single item with the current settings
+    QSizeF cellSize;
 
 public slots:
     virtual void focusOn(int index);
@@ -40,6 +43,10 @@ protected:
     virtual void updateScrollbarIndicator();
     void addItemToLayout(ThumbnailWidget *widget, int pos);
     void removeItemFromLayout(int pos);
+    void reorderLayout(const QList<int> &order);
     void removeAll();
     ThumbnailWidget *createThumbnailWidget();
+    QRectF itemRect(int index) override;
+    void itemRange(const QRectF &rect, int &first, int &last) override;
+    QSizeF contentsSize() override;
 };
@@ -53,7 +53,12 @@ void ThumbnailStripProxy::setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb
     }
 }
 
-void ThumbnailStripProxy::select(QList<int> indices) {
+void ThumbnailStripProxy::setPlaceholder(int pos, const QImage &image) {
+    if(thumbnailStrip)
+        thumbnailStrip->setPlaceholder(pos, image);
+}
+
+void ThumbnailStripProxy::select(const ItemSelection &indices) {
     if(thumbnailStrip) {
         thumbnailStrip->select(indices);
     } else {
@@ -66,11 +71,11 @@ void ThumbnailStripProxy::select(int index) {
         thumbnailStrip->select(index);
     } else {
         stateBuf.selection.clear();
-        stateBuf.selection << index;
+        stateBuf.selection.add(index);
     }
 }
 
-QList<int> ThumbnailStripProxy::selection() {
+const ItemSelection &ThumbnailStripProxy::selection() {
     if(thumbnailStrip) {
         return thumbnailStrip->selection();
     } else {
@@ -98,18 +103,31 @@ void ThumbnailStripProxy::insertItem(int index) {
     }
 }
 
+void ThumbnailStripProxy::insertItems(QList<int> indices) {
+    if(thumbnailStrip) {
+        thumbnailStrip->insertItems(indices);
+    } else {
+        stateBuf.itemCount += indices.count();
+    }
+}
+
 void ThumbnailStripProxy::removeItem(int index) {
     if(thumbnailStrip) {
         thumbnailStrip->removeItem(index);
     } else {
         stateBuf.itemCount--;
-        stateBuf.selection.removeAll(index);
-        for(int i=0; i < stateBuf.selection.count(); i++) {
-            if(stateBuf.selection[i] > index)
-                stateBuf.selection[i]--;
-        }
-        if(!stateBuf.selection.count())
-            stateBuf.selection << ((index >= stateBuf.itemCount) ? stateBuf.itemCount - 1 : index);
+        stateBuf.selection.removeAt(index);
+        if(stateBuf.selection.isEmpty())
+            stateBuf.selection.add((index >= stateBuf.itemCount) ? stateBuf.itemCount - 1 : index);
+    }
+}
+
+void ThumbnailStripProxy::removeItems(QList<int> indices) {
+    if(thumbnailStrip) {
+        thumbnailStrip->removeItems(indices);
+    } else {
+        for(int i = indices.count() - 1; i >= 0; i--)
+            removeItem(indices.at(i));
     }
 }
 
@@ -118,6 +136,13 @@ void ThumbnailStripProxy::reloadItem(int index) {
         thumbnailStrip->reloadItem(index);
 }
 
+void ThumbnailStripProxy::reorderItems(QList<int> order) {
+    if(thumbnailStrip)
+        thumbnailStrip->reorderItems(order);
+    else
+        stateBuf.selection.reorder(order);
+}
+
 void ThumbnailStripProxy::setDragHover(int index) {
     if(thumbnailStrip)
         thumbnailStrip->setDragHover(index);
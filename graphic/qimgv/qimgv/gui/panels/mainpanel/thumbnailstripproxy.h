@@ -4,7 +4,7 @@
 #include <QMutexLocker>
 
 struct ThumbnailStripStateBuffer {
-    QList<int> selection;
+    ItemSelection selection;
     int itemCount = 0;
 };
 
@@ -21,14 +21,18 @@ public:
 public slots:
     virtual void populate(int) override;
     virtual void setThumbnail(int pos, std::shared_ptr<Thumbnail> thumb) override;
-    virtual void select(QList<int>) override;
+    virtual void setPlaceholder(int pos, const QImage &image) override;
+    virtual void select(const ItemSelection &) override;
     virtual void select(int) override;
-    virtual QList<int> selection() override;
+    virtual const ItemSelection &selection() override;
     virtual void focusOn(int) override;
     virtual void focusOnSelection() override;
     virtual void insertItem(int index) override;
+    virtual void insertItems(QList<int> indices) override;
     virtual void removeItem(int index) override;
+    virtual void removeItems(QList<int> indices) override;
     virtual void reloadItem(int index) override;
+    virtual void reorderItems(QList<int> order) override;
     virtual void setDragHover(int index) override;
     virtual void setDirectoryPath(QString path) override;
     void addItem();
@@ -38,7 +42,7 @@ protected:
 
 signals:
     void itemActivated(int) override;
-    void thumbnailsRequested(QList<int>, int, bool, bool) override;
+    void thumbnailsRequested(QList<int>, int, bool, bool, bool) override;
     void draggedOut() override;
     void draggedToBookmarks(QList<int>) override;
     void droppedInto(const QMimeData*, QObject*, int) override;
@@ -20,6 +20,12 @@ ImageViewerV2::ImageViewerV2(QWidget *parent) : QGraphicsView(parent),
     maxScale(500.0f),
     fitWindowScale(0.125f),
     mViewLock(LOCK_NONE),
+    currentFrame(0),
+    currentFrameDelay(0),
+    pendingFrame(-1),
+    deferredFrame(-1),
+    animationPlaying(false),
+    waitingForFrame(false),
     imageFitMode(FIT_WINDOW),
     mScalingFilter(QI_FILTER_BILINEAR),
     imageFitModeDefault(FIT_WINDOW),
@@ -51,6 +57,11 @@ ImageViewerV2::ImageViewerV2(QWidget *parent) : QGraphicsView(parent),
 
     animationTimer = new QTimer(this);
     animationTimer->setSingleShot(true);
+    animationTimer->setTimerType(Qt::PreciseTimer);
+
+    animationDecoder = new AnimationDecoder(this);
+    connect(animationDecoder, &AnimationDecoder::frameAvailable, this, &ImageViewerV2::onFrameDecoded, Qt::QueuedConnection);
+    connect(animationDecoder, &AnimationDecoder::failed, this, &ImageViewerV2::onDecoderFailed, Qt::QueuedConnection);
 
     scaleTimer = new QTimer(this);
     scaleTimer->setSingleShot(true);
@@ -97,10 +108,12 @@ ImageViewerV2::ImageViewerV2(QWidget *parent) : QGraphicsView(parent),
 }
 
 ImageViewerV2::~ImageViewerV2() {
+    animationDecoder->close();
 }
 
 void ImageViewerV2::readSettings() {
     transparencyGrid = settings->transparencyGrid();
+    pixmapItem.setTransparencyGrid(transparencyGrid, checkboard);
     smoothAnimatedImages = settings->smoothAnimatedImages();
     smoothUpscaling = settings->smoothUpscaling();
     expandImage = settings->expandImage();
@@ -141,25 +154,26 @@ void ImageViewerV2::onFullscreenModeChanged(bool mode) {
 }
 
 void ImageViewerV2::startAnimation() {
-    if(movie && movie->frameCount() > 1) {
+    if(movie && movie->frameCount() > 1 && animationDecoder->isRunning()) {
         stopAnimation();
         emit animationPaused(false);
-        //movie->jumpToFrame(0);
-        //emit frameChanged(0);
-        animationTimer->start(movie->nextFrameDelay());
+        animationPlaying = true;
+        animationTimer->start(currentFrameDelay);
     }
 }
 
 void ImageViewerV2::stopAnimation() {
     if(movie) {
         emit animationPaused(true);
+        animationPlaying = false;
+        waitingForFrame = false;
         animationTimer->stop();
     }
 }
 
 void ImageViewerV2::pauseResume() {
     if(movie) {
-        if(animationTimer->isActive())
+        if(animationPlaying)
             stopAnimation();
         else
             startAnimation();
@@ -177,70 +191,127 @@ void ImageViewerV2::disableDrags() {
 void ImageViewerV2::onAnimationTimer() {
     if(!movie)
         return;
-    if(movie->currentFrameNumber() == movie->frameCount() - 1) {
+    if(currentFrame == movie->frameCount() - 1 && !loopPlayback) {
         // last frame
-        if(!loopPlayback) {
-            emit animationPaused(true);
-            emit playbackFinished();
-            return;
-        } else {
-            movie->jumpToFrame(0);
-        }
-    } else {
-        if(!movie->jumpToNextFrame()) {
-            qDebug() << "[Error] QMovie:" << movie->lastErrorString();
-            this->stopAnimation();
-            return;
+        animationPlaying = false;
+        emit animationPaused(true);
+        emit playbackFinished();
+        return;
+    }
+    if(deferredFrame != -1) {
+        // decoder holds stale frames; seek for real now that playback needs it
+        showAnimationFrame(deferredFrame);
+        return;
+    }
+    AnimationFrame frame;
+    if(!animationDecoder->takeFrame(frame)) {
+        // decoder is behind; continue from onFrameDecoded()
+        waitingForFrame = true;
+        return;
+    }
+    showDecodedFrame(frame);
+    animationTimer->start(currentFrameDelay);
+}
+
+void ImageViewerV2::onFrameDecoded() {
+    if(!movie)
+        return;
+    if(pendingFrame != -1) {
+        AnimationFrame frame;
+        while(animationDecoder->takeFrame(frame)) {
+            if(frame.number == pendingFrame) {
+                pendingFrame = -1;
+                showDecodedFrame(frame);
+                if(animationPlaying)
+                    animationTimer->start(currentFrameDelay);
+                break;
+            }
         }
+    } else if(waitingForFrame && animationPlaying) {
+        waitingForFrame = false;
+        onAnimationTimer();
     }
-    emit frameChanged(movie->currentFrameNumber());
-    std::unique_ptr<QPixmap> newFrame(new QPixmap());
-    *newFrame = movie->currentPixmap();
+}
+
+// nothing more is coming from the decoder; stay on the frame we have
+void ImageViewerV2::onDecoderFailed() {
+    // late signal from the previous file
+    if(!movie || animationDecoder->isRunning())
+        return;
+    stopAnimation();
+    pendingFrame = -1;
+    deferredFrame = -1;
+}
+
+void ImageViewerV2::showDecodedFrame(AnimationFrame &frame) {
+    currentFrame = frame.number;
+    currentFrameDelay = frame.delay;
+    emit frameChanged(currentFrame);
+    // frames come in a pixmap-compatible format, so this is just a swap
+    std::unique_ptr<QPixmap> newFrame(new QPixmap(QPixmap::fromImage(std::move(frame.image))));
     updatePixmap(std::move(newFrame));
-    animationTimer->start(movie->nextFrameDelay());
 }
 
 void ImageViewerV2::nextFrame() {
     if(!movie) {
         return;
-    } else if(movie->currentFrameNumber() == movie->frameCount() - 1) {
+    } else if(currentFrame == movie->frameCount() - 1) {
         showAnimationFrame(0);
     } else {
-        showAnimationFrame(movie->currentFrameNumber() + 1);
+        showAnimationFrame(currentFrame + 1);
     }
 }
 
 void ImageViewerV2::prevFrame() {
     if(!movie) {
         return;
-    } else if(movie->currentFrameNumber() == 0) {
+    } else if(currentFrame == 0) {
         showAnimationFrame(movie->frameCount() - 1);
     } else {
-        showAnimationFrame(movie->currentFrameNumber() - 1);
+        showAnimationFrame(currentFrame - 1);
     }
 }
 
+// seeking is asynchronous; the frame is displayed once decoder gets to it
 bool ImageViewerV2::showAnimationFrame(int frame) {
-    if(!movie || frame < 0 || frame >= movie->frameCount())
+    if(!movie || frame < 0 || frame >= movie->frameCount() || !animationDecoder->isRunning())
         return false;
-    if(movie->currentFrameNumber() == frame)
+    if(currentFrame == frame && pendingFrame == -1)
         return true;
-    // at the first glance this may seem retarded
-    // because it is
-    // unfortunately i dont see a *better* way to do seeking with QMovie
-    // QMovie::CacheAll is buggy and memory inefficient
-    if(frame < movie->currentFrameNumber())
-        movie->jumpToFrame(0);
-    while(frame != movie->currentFrameNumber()) {
-        if(!movie->jumpToNextFrame()) {
-            qDebug() << "[Error] QMovie:" << movie->lastErrorString();
-            break;
+    animationTimer->stop();
+    waitingForFrame = false;
+    deferredFrame = -1;
+    // most likely already buffered when stepping forward
+    AnimationFrame next;
+    if(pendingFrame == -1 && animationDecoder->takeFrame(next) && next.number == frame) {
+        showDecodedFrame(next);
+        if(animationPlaying)
+            animationTimer->start(currentFrameDelay);
+        return true;
+    }
+    AnimationFrame snapshot;
+    bool exact = false;
+    if(animationDecoder->snapshot(frame, snapshot, exact)) {
+        if(exact) {
+            // keyframe hit; decoder only needs to continue after it
+            pendingFrame = -1;
+            showDecodedFrame(snapshot);
+            // going back means reopening the reader and decoding from frame 0,
+            // so when scrubbing backwards leave that until the next frame is needed
+            int next = (frame + 1) % movie->frameCount();
+            if(next >= animationDecoder->position())
+                animationDecoder->seek(next);
+            else
+                deferredFrame = next;
+            if(animationPlaying)
+                animationTimer->start(currentFrameDelay);
+            return true;
         }
+        // show the nearest keyframe until the exact one is decoded
+        updatePixmap(std::unique_ptr<QPixmap>(new QPixmap(QPixmap::fromImage(std::move(snapshot.image)))));
     }
-    emit frameChanged(movie->currentFrameNumber());
-    std::unique_ptr<QPixmap> newFrame(new QPixmap());
-    *newFrame = movie->currentPixmap();
-    updatePixmap(std::move(newFrame));
+    pendingFrame = frame;
+    animationDecoder->seek(frame);
     return true;
 }
 
@@ -259,9 +330,17 @@ void ImageViewerV2::showAnimation(std::shared_ptr<QMovie> _movie) {
         movie->jumpToFrame(0);
         Qt::TransformationMode mode = smoothAnimatedImages ? Qt::SmoothTransformation : Qt::FastTransformation;
         pixmapItem.setTransformationMode(mode);
+        // first frame is already decoded by QMovie, show it right away
+        // and let the decoder thread take care of the rest
         std::unique_ptr<QPixmap> newFrame(new QPixmap());
         *newFrame = movie->currentPixmap();
         updatePixmap(std::move(newFrame));
+        currentFrame = 0;
+        currentFrameDelay = movie->nextFrameDelay();
+        if(movie->frameCount() > 1) {
+            animationDecoder->setLoop(loopPlayback);
+            animationDecoder->open(movie->fileName(), movie->format(), 1);
+        }
         emit durationChanged(movie->frameCount());
         emit frameChanged(0);
 
@@ -322,7 +401,12 @@ void ImageViewerV2::reset() {
     pixmapItem.setOffset(10000,10000);
     pixmap.reset();
     stopAnimation();
+    animationDecoder->close();
     movie = nullptr;
+    currentFrame = 0;
+    currentFrameDelay = 0;
+    pendingFrame = -1;
+    deferredFrame = -1;
     centerOn(10000,10000);
     // when this view is not in focus this it won't update the background
     // so we force it here
@@ -367,6 +451,7 @@ void ImageViewerV2::scrollRight() {
 // temporary override till application restart
 void ImageViewerV2::toggleTransparencyGrid() {
     transparencyGrid = !transparencyGrid;
+    pixmapItem.setTransparencyGrid(transparencyGrid, checkboard);
     scene->update();
 }
 
@@ -381,6 +466,7 @@ void ImageViewerV2::setScalingFilter(ScalingFilter filter) {
 }
 
 void ImageViewerV2::setLoopPlayback(bool mode) {
+    animationDecoder->setLoop(mode);
     if(movie && mode && loopPlayback != mode)
         startAnimation();
     loopPlayback = mode;
@@ -672,9 +758,12 @@ void ImageViewerV2::showEvent(QShowEvent *event) {
 
 void ImageViewerV2::drawBackground(QPainter *painter, const QRectF &rect) {
     QGraphicsView::drawBackground(painter, rect);
-    if(!isDisplaying() || !transparencyGrid || !pixmap->hasAlphaChannel())
+    // pixmapItem composites the grid into its own tiles
+    if(!isDisplaying() || !transparencyGrid || !pixmap->hasAlphaChannel() || pixmapItem.isVisible())
         return;
-    painter->drawTiledPixmap(pixmapItem.sceneBoundingRect(), *checkboard);
+    QRectF imageRect = pixmapItem.sceneBoundingRect();
+    QRectF exposed = imageRect.intersected(rect);
+    painter->drawTiledPixmap(exposed, *checkboard, exposed.topLeft() - imageRect.topLeft());
 }
 
 // simple pan behavior (cursor stops at the screen edges)
@@ -1121,7 +1210,7 @@ bool ImageViewerV2::lockViewEnabled() {
 void ImageViewerV2::saveViewportPos() {
     if(mViewLock != LOCK_ALL)
         return;
-    QGraphicsPixmapItem *item = &pixmapItem;
+    TiledPixmapItem *item = &pixmapItem;
     QPointF sceneCenter = mapToScene( viewport()->rect().center() ) + QPointF(1,1);
     auto itemRect = item->sceneBoundingRect();
     savedViewportPos.setX(qBound(qreal(0), (sceneCenter.x() - itemRect.left()) / itemRect.width(),  qreal(1)));
@@ -1129,7 +1218,7 @@ void ImageViewerV2::saveViewportPos() {
 }
 
 void ImageViewerV2::applySavedViewportPos() {
-    QGraphicsPixmapItem *item = &pixmapItem;
+    TiledPixmapItem *item = &pixmapItem;
     auto itemRect = item->sceneBoundingRect();
     QPointF newScenePos;
     newScenePos.setX(itemRect.left() + itemRect.width()  * savedViewportPos.x());
@@ -14,6 +14,8 @@
 #include <memory>
 #include <cmath>
 #include "settings.h"
+#include "components/animationdecoder/animationdecoder.h"
+#include "tiledpixmapitem.h"
 
 enum MouseInteractionState {
     MOUSE_NONE,
@@ -115,6 +117,8 @@ protected:
 
 protected slots:
     void onAnimationTimer();
+    void onFrameDecoded();
+    void onDecoderFailed();
 
 private slots:
     void requestScaling();
@@ -128,8 +132,10 @@ private:
     std::shared_ptr<QPixmap> pixmap;
     std::unique_ptr<QPixmap> pixmapScaled;
     std::shared_ptr<QMovie> movie;
-    QGraphicsPixmapItem pixmapItem, pixmapItemScaled;
+    TiledPixmapItem pixmapItem;
+    QGraphicsPixmapItem pixmapItemScaled;
     QTimer *animationTimer, *scaleTimer;
+    AnimationDecoder *animationDecoder;
     QScrollBar *hs, *vs;
     QPoint mouseMoveStartPos, mousePressPos, drawPos;
     bool transparencyGrid, expandImage,    smoothAnimatedImages,
@@ -156,6 +162,8 @@ private:
     float minScale, maxScale, fitWindowScale, expandLimit, lockedScale;
     QPointF savedViewportPos;
     ViewLockMode mViewLock;
+    int currentFrame, currentFrameDelay, pendingFrame, deferredFrame;
+    bool animationPlaying, waitingForFrame;
 
     QPair<QPointF, QPoint> zoomAnchor; // [pixmap coords, viewport coords]
 
@@ -188,6 +196,7 @@ private:
     void swapToOriginalPixmap();
     void setZoomAnchor(QPoint viewportPos);
     void updatePixmap(std::unique_ptr<QPixmap> newPixmap);
+    void showDecodedFrame(AnimationFrame &frame);
     Qt::TransformationMode selectTransformationMode();
     void centerIfNecessary();
     void snapToEdges();
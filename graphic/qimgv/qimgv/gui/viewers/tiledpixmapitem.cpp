@@ -0,0 +1,159 @@
+#include "tiledpixmapitem.h"
+
+TiledPixmapItem::TiledPixmapItem(QGraphicsItem *parent)
+    : QGraphicsItem(parent),
+      mTransformationMode(Qt::FastTransformation),
+      mTransparencyGrid(false),
+      mCheckerboard(nullptr)
+{
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    compositeCache.setMaxCost(COMPOSITE_CACHE_SIZE);
+}
+
+void TiledPixmapItem::setPixmap(const QPixmap &pixmap) {
+    prepareGeometryChange();
+    mPixmap = pixmap;
+    logicalSize = QSizeF(mPixmap.size()) / mPixmap.devicePixelRatioF();
+    updateTiles();
+    update();
+}
+
+QPixmap TiledPixmapItem::pixmap() const {
+    return mPixmap;
+}
+
+QPointF TiledPixmapItem::offset() const {
+    return mOffset;
+}
+
+void TiledPixmapItem::setOffset(const QPointF &offset) {
+    if(offset == mOffset)
+        return;
+    prepareGeometryChange();
+    mOffset = offset;
+    compositeCache.clear();
+    update();
+}
+
+void TiledPixmapItem::setOffset(qreal x, qreal y) {
+    setOffset(QPointF(x, y));
+}
+
+Qt::TransformationMode TiledPixmapItem::transformationMode() const {
+    return mTransformationMode;
+}
+
+void TiledPixmapItem::setTransformationMode(Qt::TransformationMode mode) {
+    if(mode == mTransformationMode)
+        return;
+    mTransformationMode = mode;
+    compositeCache.clear();
+    update();
+}
+
+void TiledPixmapItem::setTransparencyGrid(bool mode, const QPixmap *checkerboard) {
+    mTransparencyGrid = mode;
+    mCheckerboard = checkerboard;
+    compositeCache.clear();
+    update();
+}
+
+QRectF TiledPixmapItem::boundingRect() const {
+    if(mPixmap.isNull())
+        return QRectF();
+    return QRectF(mOffset, logicalSize);
+}
+
+void TiledPixmapItem::updateTiles() {
+    tiles.clear();
+    compositeCache.clear();
+    if(mPixmap.isNull())
+        return;
+    for(int y = 0; y < mPixmap.height(); y += TILE_SIZE) {
+        for(int x = 0; x < mPixmap.width(); x += TILE_SIZE)
+            tiles.append(QRect(x, y, TILE_SIZE, TILE_SIZE).intersected(mPixmap.rect()));
+    }
+}
+
+// tile rect in item coordinates
+QRectF TiledPixmapItem::tileTarget(const QRect &tile) const {
+    qreal dpr = mPixmap.devicePixelRatioF();
+    return QRectF(mOffset + QPointF(tile.topLeft()) / dpr, QSizeF(tile.size()) / dpr);
+}
+
+// Smooth sampling near the edge of a source rect is clamped, which shows up
+// as seams between tiles. Sample one extra pixel around and clip instead.
+void TiledPixmapItem::drawTile(QPainter *painter, const QRect &tile, const QRectF &target) {
+    if(mTransformationMode == Qt::FastTransformation || tiles.count() == 1) {
+        painter->drawPixmap(target, mPixmap, tile);
+        return;
+    }
+    QRect source = tile.adjusted(-1, -1, 1, 1).intersected(mPixmap.rect());
+    painter->save();
+    painter->setClipRect(target, Qt::IntersectClip);
+    painter->drawPixmap(tileTarget(source), mPixmap, source);
+    painter->restore();
+}
+
+QPointF TiledPixmapItem::checkerboardOffset(const QPointF &scenePos) const {
+    // keep checkerboard aligned to the image corner
+    return scenePos - mapToScene(boundingRect().topLeft());
+}
+
+QPixmap *TiledPixmapItem::compositeTile(int index, const QRect &sceneRect) {
+    QPixmap *composite = compositeCache.object(index);
+    if(composite)
+        return composite;
+    const QRect &tile = tiles.at(index);
+    qreal dpr = mPixmap.devicePixelRatioF();
+    composite = new QPixmap(sceneRect.size() * dpr);
+    composite->setDevicePixelRatio(dpr);
+    QPainter p(composite);
+    // keep checkerboard aligned to the image corner, as it was before
+    p.drawTiledPixmap(QRectF(QPointF(0, 0), sceneRect.size()), *mCheckerboard, checkerboardOffset(sceneRect.topLeft()));
+    p.setRenderHint(QPainter::SmoothPixmapTransform, mTransformationMode == Qt::SmoothTransformation);
+    // item -> local composite coords
+    p.translate(-QPointF(sceneRect.topLeft()));
+    p.setTransform(sceneTransform(), true);
+    drawTile(&p, tile, tileTarget(tile));
+    p.end();
+    int cost = static_cast<int>(qMax<qint64>(qint64(composite->width()) * composite->height() * 4 / 1024, 1));
+    compositeCache.insert(index, composite, cost);
+    return composite;
+}
+
+void TiledPixmapItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(widget)
+    if(mPixmap.isNull())
+        return;
+    bool composite = mTransparencyGrid && mCheckerboard && mPixmap.hasAlphaChannel();
+    if(composite && compositeTransform != sceneTransform()) {
+        compositeCache.clear();
+        compositeTransform = sceneTransform();
+    }
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, mTransformationMode == Qt::SmoothTransformation);
+    const QRectF exposed = option->exposedRect;
+    for(int i = 0; i < tiles.count(); i++) {
+        QRectF target = tileTarget(tiles.at(i));
+        if(!target.intersects(exposed))
+            continue;
+        if(!composite) {
+            drawTile(painter, tiles.at(i), target);
+            continue;
+        }
+        // composited tiles are drawn 1:1 in scene space
+        QRect sceneRect = mapRectToScene(target).toAlignedRect();
+        painter->save();
+        painter->setTransform(sceneTransform().inverted(), true);
+        if(qint64(sceneRect.width()) * sceneRect.height() <= MAX_COMPOSITE_AREA) {
+            painter->drawPixmap(sceneRect.topLeft(), *compositeTile(i, sceneRect));
+            painter->restore();
+        } else {
+            // zoomed in too far to cache; draw just the exposed part
+            QRectF visible = QRectF(sceneRect).intersected(mapRectToScene(exposed));
+            painter->drawTiledPixmap(visible, *mCheckerboard, checkerboardOffset(visible.topLeft()));
+            painter->restore();
+            drawTile(painter, tiles.at(i), target);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QStyleOptionGraphicsItem>
+#include <QPainter>
+#include <QPixmap>
+#include <QCache>
+#include <cmath>
+
+/* Drop-in for QGraphicsPixmapItem, meant for large images.
+ * The pixmap is split into a grid of fixed-size tiles (source rects into
+ * the same pixmap, nothing is copied); only tiles that intersect the
+ * exposed area get painted. With transparency grid enabled, tiles are
+ * composited over the checkerboard once per zoom level and cached.
+ */
+class TiledPixmapItem : public QGraphicsItem
+{
+public:
+    TiledPixmapItem(QGraphicsItem *parent = nullptr);
+
+    void setPixmap(const QPixmap &pixmap);
+    QPixmap pixmap() const;
+
+    QPointF offset() const;
+    void setOffset(const QPointF &offset);
+    void setOffset(qreal x, qreal y);
+
+    Qt::TransformationMode transformationMode() const;
+    void setTransformationMode(Qt::TransformationMode mode);
+
+    void setTransparencyGrid(bool mode, const QPixmap *checkerboard);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+private:
+    QPixmap mPixmap;
+    QPointF mOffset;
+    Qt::TransformationMode mTransformationMode;
+    QSizeF logicalSize;
+    QVector<QRect> tiles; // in pixmap pixels
+    bool mTransparencyGrid;
+    const QPixmap *mCheckerboard;
+    QCache<int, QPixmap> compositeCache;
+    QTransform compositeTransform;
+
+    void updateTiles();
+    QRectF tileTarget(const QRect &tile) const;
+    void drawTile(QPainter *painter, const QRect &tile, const QRectF &target);
+    QPixmap *compositeTile(int index, const QRect &sceneRect);
+    QPointF checkerboardOffset(const QPointF &scenePos) const;
+
+    const int TILE_SIZE = 512;
+    const int COMPOSITE_CACHE_SIZE = 128 * 1024; // KB
+    const qint64 MAX_COMPOSITE_AREA = 2048 * 2048;
+};
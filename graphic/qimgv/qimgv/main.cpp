@@ -101,6 +101,7 @@ int main(int argc, char *argv[]) {
     qRegisterMetaType<Script>("Script");
     qRegisterMetaType<std::shared_ptr<Image>>("std::shared_ptr<Image>");
     qRegisterMetaType<std::shared_ptr<Thumbnail>>("std::shared_ptr<Thumbnail>");
+    qRegisterMetaType<std::vector<FSEntry>>("std::vector<FSEntry>");
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     qRegisterMetaTypeStreamOperators<Script>("Script");
 #endif
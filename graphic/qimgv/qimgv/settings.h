@@ -104,7 +104,6 @@ public:
     QStringList supportedMimeTypes();
     QList<QByteArray> supportedFormats();
     QString supportedFormatsFilter();
-    QString supportedFormatsRegex();
     int panelPreviewsSize();
     void setPanelPreviewsSize(int size);
     bool usePreloader();
@@ -297,6 +297,55 @@ QMap<QString, QString> DocumentInfo::getExifTags() {
     return exifTags;
 }
 
+QImage DocumentInfo::embeddedPreview() {
+    QImage preview;
+    if(mDocumentType != STATIC)
+        return preview;
+#ifdef USE_EXIV2
+    // about a 1080p screen; bigger ones take as long as the image itself
+    const quint64 maxPixels = 2100000;
+    try {
+        std::unique_ptr<Exiv2::Image> image;
+
+        image = Exiv2::ImageFactory::open(toStdString(fileInfo.filePath()));
+
+        assert(image.get() != 0);
+        image->readMetadata();
+        Exiv2::PreviewManager previewManager(*image);
+        // sorted by size, smallest first
+        Exiv2::PreviewPropertiesList list = previewManager.getPreviewProperties();
+        for(auto it = list.rbegin(); it != list.rend(); ++it) {
+            if(static_cast<quint64>(it->width_) * it->height_ > maxPixels)
+                continue;
+            Exiv2::PreviewImage data = previewManager.getPreviewImage(*it);
+            if(preview.loadFromData(reinterpret_cast<const uchar*>(data.pData()), static_cast<int>(data.size())))
+                break;
+        }
+    }
+
+// this should work with both 0.28 and <0.28
+#if not EXIV2_TEST_VERSION(0, 28, 0)
+#ifdef __WIN32
+    catch (Exiv2::BasicError<wchar_t>& e) {
+        qDebug() << "Caught Exiv2::BasicError exception:\n" << e.what() << "\n";
+        return QImage();
+    }
+#else
+    catch (Exiv2::BasicError<char>& e) {
+        qDebug() << "Caught Exiv2::BasicError exception:\n" << e.what() << "\n";
+        return QImage();
+    }
+#endif
+#endif
+
+    catch (Exiv2::Error& e) {
+        qDebug() << "Caught Exiv2 exception:\n" << e.what() << "\n";
+        return QImage();
+    }
+#endif
+    return preview;
+}
+
 void DocumentInfo::loadExifOrientation() {
     if(mDocumentType == DocumentType::VIDEO || mDocumentType == DocumentType::NONE)
         return;
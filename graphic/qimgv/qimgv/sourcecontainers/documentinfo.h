@@ -22,6 +22,7 @@
 #endif
 
 #include <QImageReader>
+#include <QImage>
 
 enum DocumentType { NONE, STATIC, ANIMATED, VIDEO };
 
@@ -46,6 +47,9 @@ public:
     void refresh();
     void loadExifTags();
     QMap<QString, QString> getExifTags();
+    // largest exif preview that is still quick to decode, not rotated;
+    // null if there is none
+    QImage embeddedPreview();
 
 private:
     QFileInfo fileInfo;
@@ -1,6 +1,8 @@
 #pragma once
 #include <QString>
+#include <QCollator>
 #include <filesystem>
+#include <optional>
 #include "utils/stuff.h"
 
 class FSEntry {
@@ -13,7 +15,9 @@ public:
     bool operator==(const QString &anotherPath) const;
 
     QString path, name;
-    std::uintmax_t size;
+    std::uintmax_t size = 0;
     std::filesystem::file_time_type modifyTime;
-    bool isDirectory;
+    bool isDirectory = false;
+    // path collation key, filled in by whoever sorts the entries
+    std::optional<QCollatorSortKey> sortKey;
 };
@@ -36,6 +36,9 @@ void ImageAnimated::loadMovie() {
     movie->jumpToFrame(0);
     mSize = movie->frameRect().size();
     mFrameCount = movie->frameCount();
+    // QMovie has just decoded it anyway; keep it for getImage() & co.
+    firstFrame.reset(new const QImage(movie->currentImage()));
+    firstFramePixmap = QPixmap();
 }
 
 int ImageAnimated::frameCount() {
@@ -67,14 +70,18 @@ bool ImageAnimated::save() {
     return false;
 }
 
-// in case of gif returns current frame
+// returns first frame
+// pixmap is converted once and then shared (QPixmap is implicitly shared)
 std::unique_ptr<QPixmap> ImageAnimated::getPixmap() {
-    return std::unique_ptr<QPixmap>(new QPixmap(mPath, mDocInfo->format().toStdString().c_str()));
+    if(firstFramePixmap.isNull())
+        firstFramePixmap = QPixmap::fromImage(*getImage());
+    return std::unique_ptr<QPixmap>(new QPixmap(firstFramePixmap));
 }
 
 std::shared_ptr<const QImage> ImageAnimated::getImage() {
-    std::shared_ptr<const QImage> img(new QImage(mPath, mDocInfo->format().toStdString().c_str()));
-    return img;
+    if(!firstFrame)
+        loadMovie();
+    return firstFrame;
 }
 
 std::shared_ptr<QMovie> ImageAnimated::getMovie() {
@@ -33,5 +33,7 @@ private:
     QSize mSize;
     int mFrameCount;
     std::shared_ptr<QMovie> movie;
+    std::shared_ptr<const QImage> firstFrame;
+    QPixmap firstFramePixmap;
     void loadMovie();
 };
@@ -0,0 +1,61 @@
+#include "test_directorysnapshot.h"
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include "../components/directorymanager/directorysnapshot.h"
+
+QTEST_MAIN(Test_DirectorySnapshot);
+
+namespace fs = std::filesystem;
+
+namespace {
+    FSEntry fileEntry(const QString &dirPath, const QString &name, std::uintmax_t size) {
+        return FSEntry(dirPath + "/" + name, name, size, fs::file_time_type(fs::file_time_type::duration(size * 1000)), false);
+    }
+}
+
+void Test_DirectorySnapshot::roundTrip() {
+    QTemporaryDir dir, cache;
+    QVERIFY(dir.isValid() && cache.isValid());
+    QString dirPath = dir.path();
+    std::vector<FSEntry> files = { fileEntry(dirPath, "a.jpg", 10), fileEntry(dirPath, "b.png", 20) };
+    std::vector<FSEntry> dirs = { FSEntry(dirPath + "/sub", "sub", true) };
+    QString snapshotFile = DirectorySnapshot::filePath(cache.path() + "/", dirPath);
+    QVERIFY(DirectorySnapshot::write(snapshotFile, dirPath, "sig", DirectorySnapshot::stamp(dirPath), files, dirs));
+
+    std::vector<FSEntry> readFiles, readDirs;
+    QVERIFY(DirectorySnapshot::read(snapshotFile, dirPath, "sig", readFiles, readDirs));
+    QCOMPARE(readFiles.size(), files.size());
+    QCOMPARE(readDirs.size(), dirs.size());
+    for(size_t i = 0; i < files.size(); i++) {
+        QCOMPARE(readFiles[i].path, files[i].path);
+        QCOMPARE(readFiles[i].name, files[i].name);
+        QCOMPARE(readFiles[i].size, files[i].size);
+        QVERIFY(readFiles[i].modifyTime == files[i].modifyTime);
+        QVERIFY(!readFiles[i].isDirectory);
+    }
+    QCOMPARE(readDirs[0].path, dirs[0].path);
+    QVERIFY(readDirs[0].isDirectory);
+}
+
+void Test_DirectorySnapshot::rejectsMismatch() {
+    QTemporaryDir dir, cache;
+    QVERIFY(dir.isValid() && cache.isValid());
+    QString dirPath = dir.path();
+    std::vector<FSEntry> files = { fileEntry(dirPath, "a.jpg", 10) }, dirs;
+    std::vector<FSEntry> readFiles, readDirs;
+    QString snapshotFile = DirectorySnapshot::filePath(cache.path() + "/", dirPath);
+
+    QVERIFY(!DirectorySnapshot::read(snapshotFile, dirPath, "sig", readFiles, readDirs));
+
+    QVERIFY(DirectorySnapshot::write(snapshotFile, dirPath, "sig", DirectorySnapshot::stamp(dirPath), files, dirs));
+    QVERIFY(!DirectorySnapshot::read(snapshotFile, dirPath, "other", readFiles, readDirs));
+    QVERIFY(!DirectorySnapshot::read(snapshotFile, dirPath + "/sub", "sig", readFiles, readDirs));
+
+    // directory changed since the snapshot was taken
+    DirectorySnapshot::Stamp stale = DirectorySnapshot::stamp(dirPath);
+    stale.modified -= 1000;
+    QVERIFY(DirectorySnapshot::write(snapshotFile, dirPath, "sig", stale, files, dirs));
+    QVERIFY(!DirectorySnapshot::read(snapshotFile, dirPath, "sig", readFiles, readDirs));
+    QVERIFY(readFiles.empty());
+}
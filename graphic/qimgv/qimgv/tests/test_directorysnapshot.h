@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QObject>
+
+class Test_DirectorySnapshot : public QObject
+{
+    Q_OBJECT
+private slots:
+    void roundTrip();
+    void rejectsMismatch();
+};
@@ -0,0 +1,69 @@
+#include "test_entryindex.h"
+
+#include <QtTest>
+#include <algorithm>
+#include "../components/directorymanager/entryindex.h"
+
+QTEST_MAIN(Test_EntryIndex);
+
+namespace {
+    FSEntry entry(const QString &path) {
+        return FSEntry(path, path, false);
+    }
+
+    void verifyAll(const std::vector<FSEntry> &vec, const EntryIndex &index) {
+        for(int i = 0; i < static_cast<int>(vec.size()); i++)
+            QCOMPARE(index.indexOf(vec[i].path), i);
+    }
+}
+
+void Test_EntryIndex::lookup() {
+    std::vector<FSEntry> vec;
+    EntryIndex index(vec);
+    QCOMPARE(index.indexOf("a"), -1);
+    vec = { entry("a"), entry("b"), entry("c") };
+    index.invalidateFrom(0);
+    verifyAll(vec, index);
+    QVERIFY(!index.contains("d"));
+    index.clear();
+    vec.clear();
+    QCOMPARE(index.indexOf("a"), -1);
+}
+
+void Test_EntryIndex::insertAndRemove() {
+    std::vector<FSEntry> vec = { entry("a"), entry("c"), entry("e") };
+    EntryIndex index(vec);
+    verifyAll(vec, index);
+
+    vec.insert(vec.begin() + 1, entry("b"));
+    index.invalidateFrom(1);
+    verifyAll(vec, index);
+
+    // several changes before the next lookup
+    vec.insert(vec.begin() + 3, entry("d"));
+    index.invalidateFrom(3);
+    vec.insert(vec.begin(), entry("0"));
+    index.invalidateFrom(0);
+    verifyAll(vec, index);
+
+    vec.erase(vec.begin() + 2);
+    index.remove("b", 2);
+    QCOMPARE(index.indexOf("b"), -1);
+    verifyAll(vec, index);
+
+    vec.erase(vec.begin() + vec.size() - 1);
+    index.remove("e", static_cast<int>(vec.size()));
+    QVERIFY(!index.contains("e"));
+    verifyAll(vec, index);
+}
+
+void Test_EntryIndex::reorder() {
+    std::vector<FSEntry> vec;
+    for(int i = 0; i < 1000; i++)
+        vec.push_back(entry(QString::number(i)));
+    EntryIndex index(vec);
+    verifyAll(vec, index);
+    std::reverse(vec.begin(), vec.end());
+    index.invalidateFrom(0);
+    verifyAll(vec, index);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class Test_EntryIndex : public QObject
+{
+    Q_OBJECT
+private slots:
+    void lookup();
+    void insertAndRemove();
+    void reorder();
+};
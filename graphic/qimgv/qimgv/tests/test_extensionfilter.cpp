@@ -0,0 +1,55 @@
+#include "test_extensionfilter.h"
+
+#include <QtTest>
+#include "../utils/extensionfilter.h"
+
+QTEST_MAIN(Test_ExtensionFilter);
+
+namespace {
+    bool matchesRaw(const ExtensionFilter &filter, const char *name) {
+        return filter.matches(name, strlen(name));
+    }
+}
+
+void Test_ExtensionFilter::matchesNames() {
+    ExtensionFilter filter({ "jpg", "JPEG", "png", "webm" });
+    QVERIFY(filter.matches(QString("a.jpg")));
+    QVERIFY(filter.matches(QString("B.JPG")));
+    QVERIFY(filter.matches(QString("c.Jpeg")));
+    QVERIFY(filter.matches(QString("..webm")));
+    QVERIFY(matchesRaw(filter, "a.jpg"));
+    QVERIFY(matchesRaw(filter, "B.JPG"));
+    QVERIFY(matchesRaw(filter, "c.Jpeg"));
+}
+
+void Test_ExtensionFilter::matchesPaths() {
+    ExtensionFilter filter({ "png" });
+    QVERIFY(filter.matches(QString("/home/user/pics/image.PNG")));
+    QVERIFY(!filter.matches(QString("/home/user/dir.png/image")));
+    QVERIFY(!matchesRaw(filter, "/home/user/dir.png/image"));
+}
+
+void Test_ExtensionFilter::rejects() {
+    ExtensionFilter filter({ "jpg", "abcdefghijklmnop" });
+    QVERIFY(!filter.matches(QString("a.jp")));
+    QVERIFY(!filter.matches(QString("a.jpgx")));
+    QVERIFY(!filter.matches(QString("noext")));
+    QVERIFY(!filter.matches(QString("a.")));
+    QVERIFY(!filter.matches(QString("")));
+    QVERIFY(!filter.matches(QString::fromUtf8("a.jpé")));
+    QVERIFY(filter.matches(QString("a.abcdefghijklmnop")));
+    QVERIFY(!filter.matches(QString("a.abcdefghijklmnopq")));
+    QVERIFY(!matchesRaw(filter, "a.abcdefghijklmnopq"));
+    QVERIFY(!matchesRaw(filter, "a.jp\xc3\xa9"));
+    QVERIFY(!ExtensionFilter().matches(QString("a.jpg")));
+}
+
+void Test_ExtensionFilter::largeSet() {
+    QList<QByteArray> list;
+    for(int i = 0; i < 500; i++)
+        list << "x" + QByteArray::number(i);
+    ExtensionFilter filter(list);
+    for(int i = 0; i < 500; i++)
+        QVERIFY(filter.matches(QString("file.X%1").arg(i)));
+    QVERIFY(!filter.matches(QString("file.x500")));
+}
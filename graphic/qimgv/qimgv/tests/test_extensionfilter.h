@@ -0,0 +1,13 @@
+#pragma once
+
+#include <QObject>
+
+class Test_ExtensionFilter : public QObject
+{
+    Q_OBJECT
+private slots:
+    void matchesNames();
+    void matchesPaths();
+    void rejects();
+    void largeSet();
+};
@@ -0,0 +1,99 @@
+#include "test_itemselection.h"
+
+#include <QtTest>
+#include "../utils/itemselection.h"
+
+QTEST_MAIN(Test_ItemSelection);
+
+void Test_ItemSelection::addAndRemove() {
+    ItemSelection selection;
+    QVERIFY(selection.isEmpty());
+    QCOMPARE(selection.last(), -1);
+    selection.add(70);
+    selection.add(3);
+    selection.add(3);
+    QCOMPARE(selection.count(), 2);
+    QCOMPARE(selection.last(), 3);
+    QVERIFY(selection.contains(70));
+    QVERIFY(!selection.contains(4));
+    QVERIFY(!selection.contains(-1));
+    QCOMPARE(selection.toList(), QList<int>() << 3 << 70);
+    // last() moves to the closest one left
+    selection.add(10);
+    selection.remove(10);
+    QCOMPARE(selection.last(), 3);
+    selection.remove(3);
+    QCOMPARE(selection.last(), 70);
+    selection.remove(70);
+    QVERIFY(selection.isEmpty());
+    QCOMPARE(selection.last(), -1);
+}
+
+void Test_ItemSelection::ranges() {
+    ItemSelection selection;
+    selection.add(5);
+    selection.addRange(200, 60);
+    QCOMPARE(selection.count(), 142);
+    QCOMPARE(selection.last(), 60);
+    QVERIFY(selection.contains(63) && selection.contains(64) && selection.contains(200));
+    QVERIFY(!selection.contains(59) && !selection.contains(201));
+    int n = 0;
+    for(auto i : selection) {
+        QVERIFY(i == 5 || (i >= 60 && i <= 200));
+        n++;
+    }
+    QCOMPARE(n, selection.count());
+    // overlapping range only counts new items
+    selection.addRange(0, 63);
+    QCOMPARE(selection.count(), 201);
+}
+
+void Test_ItemSelection::shift() {
+    ItemSelection selection;
+    selection.add(0);
+    selection.add(63);
+    selection.add(64);
+    selection.add(130);
+    selection.insertAt(63);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 64 << 65 << 131);
+    QCOMPARE(selection.last(), 131);
+    selection.removeAt(1);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 63 << 64 << 130);
+    selection.removeAt(63);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 63 << 129);
+    QCOMPARE(selection.count(), 3);
+    QCOMPARE(selection.last(), 129);
+    // nothing selected past the end
+    selection.insertAt(500);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 63 << 129);
+}
+
+void Test_ItemSelection::reorder() {
+    ItemSelection selection;
+    selection.add(1);
+    selection.add(3);
+    selection.add(0);
+    // order[newIndex] == oldIndex
+    selection.reorder(QList<int>() << 3 << 2 << 1 << 0);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 2 << 3);
+    QCOMPARE(selection.last(), 3);
+    // insertion at 1, -1 is the new item
+    selection.reorder(QList<int>() << 0 << -1 << 1 << 2 << 3);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 3 << 4);
+    QCOMPARE(selection.last(), 4);
+    // removal of 1 & 4; last() goes to the closest one left
+    selection.reorder(QList<int>() << 0 << 2 << 3);
+    QCOMPARE(selection.toList(), QList<int>() << 0 << 2);
+    QCOMPARE(selection.last(), 2);
+}
+
+void Test_ItemSelection::resize() {
+    ItemSelection selection;
+    selection.addRange(0, 99);
+    selection.resize(70);
+    QCOMPARE(selection.count(), 70);
+    QCOMPARE(selection.last(), 69);
+    QVERIFY(!selection.contains(70));
+    selection.resize(0);
+    QVERIFY(selection.isEmpty());
+}
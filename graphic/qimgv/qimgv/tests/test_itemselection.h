@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+class Test_ItemSelection : public QObject
+{
+    Q_OBJECT
+private slots:
+    void addAndRemove();
+    void ranges();
+    void shift();
+    void reorder();
+    void resize();
+};
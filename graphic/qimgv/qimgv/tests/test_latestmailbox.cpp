@@ -0,0 +1,100 @@
+#include "test_latestmailbox.h"
+
+#include <QtTest>
+#include <QThreadPool>
+#include <atomic>
+#include "../utils/latestmailbox.h"
+
+QTEST_MAIN(Test_LatestMailbox);
+
+namespace {
+    // counts live instances to catch leaked / double freed slot entries
+    struct Tracked {
+        static std::atomic<int> alive;
+        int value;
+        Tracked(int v = -1) : value(v) { alive++; }
+        Tracked(const Tracked &other) : value(other.value) { alive++; }
+        Tracked &operator=(const Tracked &other) { value = other.value; return *this; }
+        ~Tracked() { alive--; }
+    };
+    std::atomic<int> Tracked::alive(0);
+}
+
+void Test_LatestMailbox::latestWins() {
+    LatestMailbox<int> mailbox;
+    int value;
+    quint64 gen;
+    QVERIFY(!mailbox.take(value, gen));
+    // first post asks the caller to start a consumer, the rest do not
+    QVERIFY(mailbox.post(1));
+    QVERIFY(!mailbox.post(2));
+    QVERIFY(!mailbox.post(3));
+    QVERIFY(mailbox.take(value, gen));
+    QCOMPARE(value, 3);
+    QVERIFY(mailbox.isCurrent(gen));
+    QVERIFY(!mailbox.take(value, gen));
+    QVERIFY(!mailbox.finish());
+    QVERIFY(mailbox.post(4));
+}
+
+void Test_LatestMailbox::staleGeneration() {
+    LatestMailbox<int> mailbox;
+    int value;
+    quint64 gen, posted;
+    mailbox.post(1);
+    QVERIFY(mailbox.take(value, gen));
+    // new request arrives while the consumer is busy
+    QVERIFY(!mailbox.post(2, &posted));
+    QVERIFY(!mailbox.isCurrent(gen));
+    QVERIFY(mailbox.take(value, gen));
+    QCOMPARE(value, 2);
+    QCOMPARE(gen, posted);
+    QVERIFY(mailbox.isCurrent(gen));
+    // consumer must keep going if something came after the last take()
+    mailbox.post(3);
+    QVERIFY(mailbox.finish());
+    QVERIFY(mailbox.take(value, gen));
+    QCOMPARE(value, 3);
+    QVERIFY(!mailbox.finish());
+}
+
+void Test_LatestMailbox::stress() {
+    const int count = 200000;
+    std::atomic<int> consumers(0), overlaps(0), disorder(0), lastValue(-1);
+    {
+        LatestMailbox<Tracked> mailbox;
+        QThreadPool pool;
+        pool.setMaxThreadCount(4);
+        auto consume = [&]() {
+            Tracked item;
+            quint64 gen, prevGen = 0;
+            do {
+                if(consumers.fetch_add(1) != 0)
+                    overlaps++;
+                while(mailbox.take(item, gen)) {
+                    if(gen <= prevGen || item.value <= lastValue.load())
+                        disorder++;
+                    prevGen = gen;
+                    lastValue.store(item.value);
+                }
+                consumers--;
+            } while(mailbox.finish());
+        };
+        for(int i = 0; i < count; i++) {
+            if(mailbox.post(Tracked(i)))
+                pool.start(consume);
+        }
+        pool.waitForDone();
+        // nothing may be left behind once the consumer went idle
+        Tracked leftover;
+        quint64 gen;
+        QVERIFY(!mailbox.take(leftover, gen));
+        QVERIFY(mailbox.isCurrent(count));
+    }
+    QCOMPARE(overlaps.load(), 0);
+    QCOMPARE(disorder.load(), 0);
+    QCOMPARE(lastValue.load(), count - 1);
+    QCOMPARE(Tracked::alive.load(), 0);
+}
+
+#include "test_latestmailbox.moc"
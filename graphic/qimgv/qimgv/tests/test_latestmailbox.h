@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class Test_LatestMailbox : public QObject
+{
+    Q_OBJECT
+private slots:
+    void latestWins();
+    void staleGeneration();
+    void stress();
+};
@@ -0,0 +1,136 @@
+#include "test_placeholderindex.h"
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include "../components/cache/placeholderindex.h"
+
+QTEST_MAIN(Test_PlaceholderIndex);
+
+namespace {
+    QImage filled(int width, int height, QColor color) {
+        QImage image(width, height, QImage::Format_RGB32);
+        image.fill(color);
+        return image;
+    }
+}
+
+void Test_PlaceholderIndex::make() {
+    // cropped square thumbnail of a wide image keeps the original aspect
+    QImage placeholder = PlaceholderIndex::make(filled(100, 100, Qt::red), QSize(4000, 1000));
+    QCOMPARE(placeholder.size(), QSize(8, 2));
+    QCOMPARE(placeholder.format(), QImage::Format_RGB888);
+    QCOMPARE(placeholder.pixelColor(3, 1), QColor(Qt::red));
+
+    QCOMPARE(PlaceholderIndex::make(filled(50, 100, Qt::red), QSize()).size(), QSize(4, 8));
+    QCOMPARE(PlaceholderIndex::make(filled(100, 1, Qt::red), QSize(10000, 1)).size(), QSize(8, 1));
+    QVERIFY(PlaceholderIndex::make(QImage(), QSize(10, 10)).isNull());
+}
+
+void Test_PlaceholderIndex::makeRotated() {
+    // exif-rotated portrait thumbnail, original size is from before the rotation
+    QCOMPARE(PlaceholderIndex::make(filled(75, 100, Qt::red), QSize(4000, 3000)).size(), QSize(6, 8));
+    // cropped: the caller passes the rotated size
+    QCOMPARE(PlaceholderIndex::make(filled(100, 100, Qt::red), QSize(3000, 4000)).size(), QSize(6, 8));
+}
+
+void Test_PlaceholderIndex::roundTrip() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    PlaceholderIndex index(dir.path() + "/placeholders");
+    QVERIFY(index.get("/a.jpg").isNull());
+    QVERIFY(!index.contains("/a.jpg"));
+
+    QImage placeholder = PlaceholderIndex::make(filled(64, 48, Qt::blue), QSize(640, 480));
+    index.insert("/a.jpg", placeholder);
+    QVERIFY(index.contains("/a.jpg"));
+    QImage read = index.get("/a.jpg");
+    QCOMPARE(read.size(), QSize(8, 6));
+    QCOMPARE(read, placeholder);
+
+    // too big to be a placeholder
+    index.insert("/b.jpg", filled(64, 48, Qt::blue));
+    QVERIFY(!index.contains("/b.jpg"));
+    QCOMPARE(index.count(), 1);
+}
+
+void Test_PlaceholderIndex::persists() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filePath = dir.path() + "/placeholders";
+    {
+        PlaceholderIndex index(filePath);
+        index.insert("/a.jpg", filled(8, 8, Qt::red));
+        index.insert("/b.jpg", filled(8, 4, Qt::green));
+    }
+    PlaceholderIndex index(filePath);
+    // get() doesn't read the file itself
+    QVERIFY(index.get("/a.jpg").isNull());
+    index.preload();
+    QCOMPARE(index.count(), 2);
+    QCOMPARE(index.get("/a.jpg").pixelColor(0, 0), QColor(Qt::red));
+    QCOMPARE(index.get("/b.jpg").size(), QSize(8, 4));
+}
+
+void Test_PlaceholderIndex::laterRecordWins() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filePath = dir.path() + "/placeholders";
+    {
+        PlaceholderIndex index(filePath);
+        index.insert("/a.jpg", filled(8, 8, Qt::red));
+        index.insert("/a.jpg", filled(4, 8, Qt::green));
+        QCOMPARE(index.count(), 1);
+    }
+    PlaceholderIndex index(filePath);
+    QCOMPARE(index.count(), 1);
+    QImage read = index.get("/a.jpg");
+    QCOMPARE(read.size(), QSize(4, 8));
+    QCOMPARE(read.pixelColor(0, 0), QColor(Qt::green));
+}
+
+void Test_PlaceholderIndex::pruned() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filePath = dir.path() + "/placeholders";
+    {
+        PlaceholderIndex index(filePath, 10);
+        // rewritten and pruned at 10% over the limit
+        for(int i = 0; i < 11; i++)
+            index.insert(QString("/%1.jpg").arg(i), filled(8, 8, Qt::red));
+        QCOMPARE(index.count(), 11);
+        index.insert("/11.jpg", filled(8, 8, Qt::red));
+        QCOMPARE(index.count(), 10);
+        QVERIFY(!index.contains("/0.jpg"));
+        QVERIFY(!index.contains("/1.jpg"));
+        QVERIFY(index.contains("/2.jpg"));
+        QVERIFY(index.contains("/11.jpg"));
+    }
+    // the oldest go first on load too
+    PlaceholderIndex index(filePath, 5);
+    QCOMPARE(index.count(), 5);
+    QVERIFY(!index.contains("/6.jpg"));
+    QVERIFY(index.contains("/7.jpg"));
+    QVERIFY(index.contains("/11.jpg"));
+}
+
+void Test_PlaceholderIndex::tornRecord() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filePath = dir.path() + "/placeholders";
+    {
+        PlaceholderIndex index(filePath);
+        index.insert("/a.jpg", filled(8, 8, Qt::red));
+    }
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write("\x00\x00\x00\x10garbage", 11);
+    file.close();
+    {
+        PlaceholderIndex index(filePath);
+        QCOMPARE(index.count(), 1);
+        index.insert("/b.jpg", filled(8, 8, Qt::blue));
+    }
+    PlaceholderIndex index(filePath);
+    QCOMPARE(index.count(), 2);
+    QVERIFY(index.contains("/b.jpg"));
+}
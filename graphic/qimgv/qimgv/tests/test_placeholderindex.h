@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QObject>
+
+class Test_PlaceholderIndex : public QObject
+{
+    Q_OBJECT
+private slots:
+    void make();
+    void makeRotated();
+    void roundTrip();
+    void persists();
+    void laterRecordWins();
+    void pruned();
+    void tornRecord();
+};
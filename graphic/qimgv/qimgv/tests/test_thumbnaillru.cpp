@@ -0,0 +1,117 @@
+#include "test_thumbnaillru.h"
+
+#include <QtTest>
+#include "../components/cache/thumbnaillru.h"
+
+QTEST_MAIN(Test_ThumbnailLru);
+
+namespace {
+    const int SIZE = 100;
+
+    std::shared_ptr<Thumbnail> thumb() {
+        return std::make_shared<Thumbnail>("", "", SIZE, nullptr);
+    }
+}
+
+void Test_ThumbnailLru::evictsLeastRecent() {
+    ThumbnailLru lru;
+    lru.setThumbnailSize(SIZE);
+    lru.setBudget(30);
+    QVERIFY(lru.insert(0, thumb(), 10).isEmpty());
+    QVERIFY(lru.insert(1, thumb(), 10).isEmpty());
+    QVERIFY(lru.insert(2, thumb(), 10).isEmpty());
+    QVERIFY(lru.get(0));
+    QCOMPARE(lru.insert(3, thumb(), 10), QList<int>() << 1);
+    QCOMPARE(lru.usedBytes(), qint64(30));
+    QVERIFY(lru.contains(0));
+    // other sizes are not kept
+    QVERIFY(lru.insert(4, std::make_shared<Thumbnail>("", "", SIZE * 2, nullptr), 10).isEmpty());
+    QVERIFY(!lru.contains(4));
+    lru.setThumbnailSize(SIZE * 2);
+    QCOMPARE(lru.count(), 0);
+    QCOMPARE(lru.usedBytes(), qint64(0));
+}
+
+void Test_ThumbnailLru::keepsWindow() {
+    ThumbnailLru lru;
+    lru.setThumbnailSize(SIZE);
+    lru.setBudget(100);
+    for(int i = 0; i < 10; i++)
+        lru.insert(i, thumb(), 10);
+    lru.setWindow(4, 5, 2, 7);
+    lru.setBudget(40);
+    // outside of the window goes first, oldest first
+    QCOMPARE(lru.trim(), QList<int>() << 0 << 1 << 8 << 9 << 2 << 3);
+    QCOMPARE(lru.usedBytes(), qint64(40));
+    // visible items stay even over budget
+    lru.setBudget(0);
+    QCOMPARE(lru.trim(), QList<int>() << 6 << 7);
+    QVERIFY(lru.contains(4));
+    QVERIFY(lru.contains(5));
+}
+
+void Test_ThumbnailLru::shift() {
+    ThumbnailLru lru;
+    lru.setThumbnailSize(SIZE);
+    lru.setBudget(100);
+    auto a = thumb(), b = thumb(), c = thumb();
+    lru.insert(0, a, 10);
+    lru.insert(1, b, 10);
+    lru.insert(2, c, 10);
+    // insertion at 1
+    lru.shift(1, 1);
+    QCOMPARE(lru.get(0), a);
+    QVERIFY(!lru.contains(1));
+    QCOMPARE(lru.get(2), b);
+    QCOMPARE(lru.get(3), c);
+    // removal of 2
+    lru.remove(2);
+    lru.shift(3, -1);
+    QCOMPARE(lru.get(2), c);
+    QCOMPARE(lru.count(), 2);
+    QCOMPARE(lru.usedBytes(), qint64(20));
+    // recency survives the shift: 0 was used before 2
+    lru.setBudget(10);
+    QCOMPARE(lru.trim(), QList<int>() << 0);
+}
+
+void Test_ThumbnailLru::reorder() {
+    ThumbnailLru lru;
+    lru.setThumbnailSize(SIZE);
+    lru.setBudget(100);
+    auto a = thumb(), b = thumb(), c = thumb();
+    lru.insert(0, a, 10);
+    lru.insert(1, b, 10);
+    lru.insert(2, c, 10);
+    // reversed
+    lru.reorder(QList<int>() << 2 << 1 << 0);
+    QCOMPARE(lru.get(2), a);
+    QCOMPARE(lru.get(1), b);
+    QCOMPARE(lru.get(0), c);
+    // anything past the list is dropped
+    lru.reorder(QList<int>() << 0 << 1);
+    QVERIFY(!lru.contains(2));
+    QCOMPARE(lru.usedBytes(), qint64(20));
+    // -1 drops too, the rest move down
+    lru.reorder(QList<int>() << -1 << 0);
+    QCOMPARE(lru.count(), 1);
+    QCOMPARE(lru.get(0), b);
+    QCOMPARE(lru.usedBytes(), qint64(10));
+}
+
+void Test_ThumbnailLru::counters() {
+    ThumbnailLru lru;
+    lru.setThumbnailSize(SIZE);
+    lru.setBudget(100);
+    lru.insert(0, thumb(), 10);
+    QVERIFY(lru.get(0));
+    QVERIFY(!lru.get(1));
+    QVERIFY(!lru.get(2));
+    // a request already in flight
+    QVERIFY(!lru.get(2, false));
+    QCOMPARE(lru.hits(), quint64(1));
+    QCOMPARE(lru.misses(), quint64(2));
+    lru.resetCounters();
+    QCOMPARE(lru.hits(), quint64(0));
+    QCOMPARE(lru.misses(), quint64(0));
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QObject>
+
+class Test_ThumbnailLru : public QObject
+{
+    Q_OBJECT
+private slots:
+    void evictsLeastRecent();
+    void keepsWindow();
+    void shift();
+    void reorder();
+    void counters();
+};
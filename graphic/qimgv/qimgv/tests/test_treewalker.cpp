@@ -0,0 +1,66 @@
+#include "test_treewalker.h"
+
+#include <QtTest>
+#include <mutex>
+#include "../components/directorymanager/treewalker.h"
+
+QTEST_MAIN(Test_TreeWalker);
+
+namespace {
+    // fake tree: every directory below MAX_DEPTH has FANOUT children
+    const int FANOUT = 4;
+    const int MAX_DEPTH = 5;
+
+    int depthOf(const QString &path) {
+        return path.count('/');
+    }
+}
+
+void Test_TreeWalker::visitsEveryDirectoryOnce() {
+    std::mutex mutex;
+    QHash<QString, int> visited;
+    QSet<int> workersUsed;
+    TreeWalker walker([&](int worker, const QString &dirPath, QStringList &subdirs) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            visited[dirPath]++;
+            workersUsed.insert(worker);
+        }
+        if(depthOf(dirPath) < MAX_DEPTH) {
+            for(int i = 0; i < FANOUT; i++)
+                subdirs << dirPath + "/" + QString::number(i);
+        }
+        return true;
+    }, 4);
+    QCOMPARE(walker.threadCount(), 4);
+    walker.walk("r");
+
+    int expected = 0;
+    for(int d = 0, level = 1; d <= MAX_DEPTH; d++, level *= FANOUT)
+        expected += level;
+    QCOMPARE(visited.count(), expected);
+    for(auto count : visited)
+        QCOMPARE(count, 1);
+    for(auto worker : workersUsed)
+        QVERIFY(worker >= 0 && worker < 4);
+
+    // reusable
+    visited.clear();
+    walker.walk("r");
+    QCOMPARE(visited.count(), expected);
+}
+
+void Test_TreeWalker::stopsWhenVisitFails() {
+    std::atomic<int> visits(0);
+    TreeWalker walker([&](int, const QString &dirPath, QStringList &subdirs) {
+        if(visits.fetch_add(1) >= 10)
+            return false;
+        for(int i = 0; i < FANOUT; i++)
+            subdirs << dirPath + "/" + QString::number(i);
+        return true;
+    }, 3);
+    // infinite tree, has to stop on its own
+    walker.walk("r");
+    QVERIFY(visits.load() >= 11);
+    QVERIFY(visits.load() < 100);
+}
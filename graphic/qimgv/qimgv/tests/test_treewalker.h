@@ -0,0 +1,11 @@
+#pragma once
+
+#include <QObject>
+
+class Test_TreeWalker : public QObject
+{
+    Q_OBJECT
+private slots:
+    void visitsEveryDirectoryOnce();
+    void stopsWhenVisitFails();
+};
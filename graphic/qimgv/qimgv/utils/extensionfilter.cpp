@@ -0,0 +1,117 @@
+#include "extensionfilter.h"
+
+ExtensionFilter::ExtensionFilter() : mask(0), count(0) {
+}
+
+ExtensionFilter::ExtensionFilter(const QList<QByteArray> &extensions) : ExtensionFilter() {
+    setExtensions(extensions);
+}
+
+void ExtensionFilter::setExtensions(const QList<QByteArray> &extensions) {
+    // keep load factor under 1/2
+    size_t size = 16;
+    while(size < static_cast<size_t>(extensions.count()) * 2)
+        size *= 2;
+    table.assign(size, Key());
+    mask = size - 1;
+    count = 0;
+    for(auto &ext : extensions) {
+        if(ext.isEmpty() || ext.size() > MAX_LENGTH)
+            continue;
+        Key key;
+        bool valid = true;
+        for(int i = 0; i < ext.size() && valid; i++) {
+            quint8 c;
+            valid = toLower(static_cast<quint8>(ext.at(i)), c);
+            pack(key, i, c);
+        }
+        if(valid && !contains(key))
+            insert(key);
+    }
+}
+
+bool ExtensionFilter::isEmpty() const {
+    return count == 0;
+}
+
+bool ExtensionFilter::matches(const QString &fileName) const {
+    if(!count)
+        return false;
+    const QChar *data = fileName.constData();
+    int length = fileName.length();
+    int dot = length - 1;
+    while(dot >= 0 && data[dot] != '.' && data[dot] != '/')
+        dot--;
+    int extLength = length - dot - 1;
+    if(dot < 0 || data[dot] != '.' || extLength == 0 || extLength > MAX_LENGTH)
+        return false;
+    Key key;
+    for(int i = dot + 1, pos = 0; i < length; i++, pos++) {
+        quint8 c;
+        if(!toLower(data[i].unicode(), c))
+            return false;
+        pack(key, pos, c);
+    }
+    return contains(key);
+}
+
+bool ExtensionFilter::matches(const char *name, size_t length) const {
+    if(!count)
+        return false;
+    size_t extLength = 0;
+    const char *p = name + length;
+    while(p != name && *(p - 1) != '.' && *(p - 1) != '/') {
+        if(++extLength > MAX_LENGTH)
+            return false;
+        p--;
+    }
+    if(p == name || *(p - 1) != '.' || !extLength)
+        return false;
+    Key key;
+    for(size_t i = 0; i < extLength; i++) {
+        quint8 c;
+        if(!toLower(static_cast<quint8>(p[i]), c))
+            return false;
+        pack(key, static_cast<int>(i), c);
+    }
+    return contains(key);
+}
+
+// ascii only; anything else can't be in a format name
+bool ExtensionFilter::toLower(ushort c, quint8 &out) {
+    if(c == 0 || c > 127)
+        return false;
+    out = (c >= 'A' && c <= 'Z') ? static_cast<quint8>(c + ('a' - 'A')) : static_cast<quint8>(c);
+    return true;
+}
+
+void ExtensionFilter::pack(Key &key, int pos, quint8 c) {
+    if(pos < 8)
+        key.lo |= static_cast<quint64>(c) << (pos * 8);
+    else
+        key.hi |= static_cast<quint64>(c) << ((pos - 8) * 8);
+}
+
+quint64 ExtensionFilter::slot(const Key &key) const {
+    quint64 h = (key.lo ^ (key.hi * 0x9E3779B97F4A7C15ull)) * 0xFF51AFD7ED558CCDull;
+    return (h ^ (h >> 32)) & mask;
+}
+
+bool ExtensionFilter::contains(const Key &key) const {
+    if(table.empty())
+        return false;
+    for(quint64 i = slot(key);; i = (i + 1) & mask) {
+        if(table[i].isNull())
+            return false;
+        if(table[i] == key)
+            return true;
+    }
+}
+
+void ExtensionFilter::insert(const Key &key) {
+    quint64 i = slot(key);
+    while(!table[i].isNull())
+        i = (i + 1) & mask;
+    table[i] = key;
+    count++;
+}
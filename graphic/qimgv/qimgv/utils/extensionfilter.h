@@ -0,0 +1,48 @@
+#pragma once
+
+/* Case-insensitive "is this a supported file extension" check.
+ *
+ * Extensions are packed into two 64-bit words and stored in a small
+ * open-addressing table, so a lookup is a suffix scan, a hash and one or
+ * two integer compares. Nothing is allocated on lookup.
+ *
+ * Cheap to copy; each thread should use its own copy.
+ */
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <vector>
+
+class ExtensionFilter {
+public:
+    ExtensionFilter();
+    explicit ExtensionFilter(const QList<QByteArray> &extensions);
+
+    void setExtensions(const QList<QByteArray> &extensions);
+    bool isEmpty() const;
+
+    // accepts a file name or a full path
+    bool matches(const QString &fileName) const;
+    // raw utf8 / local 8bit name, not null terminated
+    bool matches(const char *name, size_t length) const;
+
+    static const int MAX_LENGTH = 16;
+
+private:
+    struct Key {
+        quint64 lo = 0, hi = 0;
+        bool operator==(const Key &other) const { return lo == other.lo && hi == other.hi; }
+        bool isNull() const { return !lo && !hi; }
+    };
+
+    std::vector<Key> table;
+    quint64 mask;
+    int count;
+
+    static void pack(Key &key, int pos, quint8 c);
+    static bool toLower(ushort c, quint8 &out);
+    quint64 slot(const Key &key) const;
+    bool contains(const Key &key) const;
+    void insert(const Key &key);
+};
@@ -0,0 +1,233 @@
+#include "itemselection.h"
+
+#include <QtAlgorithms>
+
+namespace {
+    const int WORD_BITS = 64;
+
+    // bits below "bit"
+    quint64 lowMask(int bit) {
+        return (quint64(1) << bit) - 1;
+    }
+}
+
+ItemSelection::const_iterator::const_iterator(const ItemSelection *_selection, int _index)
+    : selection(_selection),
+      index(_index)
+{
+}
+
+ItemSelection::const_iterator &ItemSelection::const_iterator::operator++() {
+    index = selection->nextFrom(index + 1);
+    return *this;
+}
+
+ItemSelection::ItemSelection()
+    : mCount(0),
+      mLast(-1)
+{
+}
+
+int ItemSelection::count() const {
+    return mCount;
+}
+
+bool ItemSelection::isEmpty() const {
+    return mCount == 0;
+}
+
+bool ItemSelection::contains(int index) const {
+    if(index < 0 || index / WORD_BITS >= static_cast<int>(bits.size()))
+        return false;
+    return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+int ItemSelection::last() const {
+    return mLast;
+}
+
+void ItemSelection::clear() {
+    bits.clear();
+    mCount = 0;
+    mLast = -1;
+}
+
+void ItemSelection::add(int index) {
+    if(index < 0)
+        return;
+    grow(index + 1);
+    quint64 &word = bits[index / WORD_BITS];
+    quint64 bit = quint64(1) << (index % WORD_BITS);
+    if(!(word & bit)) {
+        word |= bit;
+        mCount++;
+    }
+    mLast = index;
+}
+
+void ItemSelection::addRange(int from, int to) {
+    int lo = qMax(qMin(from, to), 0);
+    int hi = qMax(from, to);
+    if(hi < 0)
+        return;
+    grow(hi + 1);
+    for(int w = lo / WORD_BITS; w <= hi / WORD_BITS; w++) {
+        quint64 mask = ~quint64(0);
+        if(w == lo / WORD_BITS)
+            mask &= ~lowMask(lo % WORD_BITS);
+        if(w == hi / WORD_BITS)
+            mask &= ~quint64(0) >> (WORD_BITS - 1 - hi % WORD_BITS);
+        mCount += qPopulationCount(mask & ~bits[w]);
+        bits[w] |= mask;
+    }
+    mLast = qMax(to, lo);
+}
+
+void ItemSelection::remove(int index) {
+    if(!contains(index))
+        return;
+    bits[index / WORD_BITS] &= ~(quint64(1) << (index % WORD_BITS));
+    mCount--;
+    if(mLast == index)
+        mLast = closestTo(index);
+}
+
+void ItemSelection::resize(int itemCount) {
+    if(itemCount <= 0) {
+        clear();
+        return;
+    }
+    size_t words = (itemCount + WORD_BITS - 1) / WORD_BITS;
+    if(bits.size() < words)
+        return;
+    bits.resize(words);
+    if(itemCount % WORD_BITS)
+        bits.back() &= lowMask(itemCount % WORD_BITS);
+    mCount = 0;
+    for(auto word : bits)
+        mCount += qPopulationCount(word);
+    if(mLast >= itemCount)
+        mLast = closestTo(itemCount - 1);
+}
+
+void ItemSelection::insertAt(int index) {
+    index = qMax(index, 0);
+    int first = index / WORD_BITS;
+    if(first >= static_cast<int>(bits.size()))
+        return;
+    if(bits.back() >> (WORD_BITS - 1))
+        bits.push_back(0);
+    // top down, so each word still sees the old high bit of the one below
+    for(int w = static_cast<int>(bits.size()) - 1; w > first; w--)
+        bits[w] = (bits[w] << 1) | (bits[w - 1] >> (WORD_BITS - 1));
+    quint64 low = bits[first] & lowMask(index % WORD_BITS);
+    bits[first] = low | ((bits[first] & ~low) << 1);
+    if(mLast >= index)
+        mLast++;
+}
+
+void ItemSelection::removeAt(int index) {
+    if(index < 0)
+        return;
+    int first = index / WORD_BITS;
+    if(first >= static_cast<int>(bits.size()))
+        return;
+    int last = static_cast<int>(bits.size()) - 1;
+    quint64 bit = quint64(1) << (index % WORD_BITS);
+    if(bits[first] & bit)
+        mCount--;
+    quint64 low = bits[first] & lowMask(index % WORD_BITS);
+    quint64 high = bits[first] & ~lowMask(index % WORD_BITS) & ~bit;
+    bits[first] = low | (high >> 1);
+    // bottom up, so each word still sees the old low bit of the one above
+    for(int w = first; w <= last; w++) {
+        if(w > first)
+            bits[w] >>= 1;
+        if(w < last)
+            bits[w] |= (bits[w + 1] & 1) << (WORD_BITS - 1);
+    }
+    if(mLast > index)
+        mLast--;
+    else if(mLast == index)
+        mLast = closestTo(index);
+}
+
+void ItemSelection::reorder(const QList<int> &order) {
+    if(isEmpty())
+        return;
+    ItemSelection moved;
+    // where last() would be now, in case it was removed
+    int movedLast = -1, nearLast = -1;
+    for(int i = 0; i < order.count(); i++) {
+        if(nearLast == -1 && order.at(i) > mLast)
+            nearLast = i;
+        if(contains(order.at(i))) {
+            moved.add(i);
+            if(order.at(i) == mLast)
+                movedLast = i;
+        }
+    }
+    if(movedLast != -1)
+        moved.mLast = movedLast;
+    else if(nearLast != -1 && !moved.isEmpty())
+        moved.mLast = moved.closestTo(nearLast);
+    *this = moved;
+}
+
+QList<int> ItemSelection::toList() const {
+    QList<int> list;
+    list.reserve(mCount);
+    for(int index : *this)
+        list << index;
+    return list;
+}
+
+ItemSelection::const_iterator ItemSelection::begin() const {
+    return const_iterator(this, nextFrom(0));
+}
+
+ItemSelection::const_iterator ItemSelection::end() const {
+    return const_iterator(this, -1);
+}
+
+void ItemSelection::grow(int size) {
+    size_t words = (size + WORD_BITS - 1) / WORD_BITS;
+    if(bits.size() < words)
+        bits.resize(words, 0);
+}
+
+int ItemSelection::nextFrom(int index) const {
+    index = qMax(index, 0);
+    int w = index / WORD_BITS;
+    if(w >= static_cast<int>(bits.size()))
+        return -1;
+    quint64 word = bits[w] & ~lowMask(index % WORD_BITS);
+    while(!word) {
+        if(++w >= static_cast<int>(bits.size()))
+            return -1;
+        word = bits[w];
+    }
+    return w * WORD_BITS + qCountTrailingZeroBits(word);
+}
+
+int ItemSelection::prevFrom(int index) const {
+    if(index < 0 || bits.empty())
+        return -1;
+    index = qMin(index, static_cast<int>(bits.size()) * WORD_BITS - 1);
+    int w = index / WORD_BITS;
+    quint64 word = bits[w] & (~quint64(0) >> (WORD_BITS - 1 - index % WORD_BITS));
+    while(!word) {
+        if(--w < 0)
+            return -1;
+        word = bits[w];
+    }
+    return w * WORD_BITS + WORD_BITS - 1 - qCountLeadingZeroBits(word);
+}
+
+int ItemSelection::closestTo(int index) const {
+    int next = nextFrom(index);
+    int prev = prevFrom(index);
+    if(next == -1 || prev == -1)
+        return qMax(next, prev);
+    return (next - index <= index - prev) ? next : prev;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+/* Selected item indices of a directory view.
+ *
+ * One bit per item: membership is a single lookup, select-all or a range
+ * is a word fill, iteration skips empty words and goes in ascending order.
+ * The bits grow as needed; resize() drops indices past the item count.
+ *
+ * last() is the index selected most recently, which keyboard navigation
+ * and range selection start from. It is always part of the selection
+ * unless the selection is empty.
+ */
+
+#include <QList>
+#include <vector>
+
+class ItemSelection {
+public:
+    class const_iterator {
+    public:
+        int operator*() const { return index; }
+        const_iterator &operator++();
+        bool operator==(const const_iterator &other) const { return index == other.index; }
+        bool operator!=(const const_iterator &other) const { return index != other.index; }
+
+    private:
+        friend class ItemSelection;
+        const_iterator(const ItemSelection *_selection, int _index);
+        const ItemSelection *selection;
+        int index;
+    };
+
+    ItemSelection();
+    int count() const;
+    bool isEmpty() const;
+    bool contains(int index) const;
+    // -1 when empty
+    int last() const;
+
+    void clear();
+    // index becomes last()
+    void add(int index);
+    // both ends included, in either order; "to" becomes last()
+    void addRange(int from, int to);
+    // last() moves to the closest selected index
+    void remove(int index);
+    void resize(int itemCount);
+    // an item was inserted / removed at index, the ones after it move
+    void insertAt(int index);
+    void removeAt(int index);
+    // items were re-sorted, inserted or removed; order[newIndex] == oldIndex,
+    // -1 for new items. last() moves to the closest selected index if it's gone
+    void reorder(const QList<int> &order);
+
+    QList<int> toList() const;
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    std::vector<quint64> bits;
+    int mCount, mLast;
+    void grow(int size);
+    // -1 if there is none
+    int nextFrom(int index) const;
+    int prevFrom(int index) const;
+    int closestTo(int index) const;
+};
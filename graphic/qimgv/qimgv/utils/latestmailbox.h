@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <utility>
+
+/* Single-slot "latest request wins" mailbox.
+ *
+ * post() replaces whatever is waiting in the slot, so a consumer that is
+ * busy with an older value will only ever see the newest one afterwards.
+ * Every posted value gets a generation number; a consumer can call
+ * isCurrent() when it is done to find out if its result is already stale.
+ *
+ * post() is meant to be called from one thread (gui), take() / finish()
+ * from one consumer at a time. No locks are involved on either side.
+ *
+ * Consumer loop:
+ *     do {
+ *         while(mailbox.take(value, gen))
+ *             process(value, gen);
+ *     } while(mailbox.finish());
+ */
+
+template<typename T>
+class LatestMailbox {
+public:
+    LatestMailbox() : slot(nullptr), generation(0), busy(false) { }
+    ~LatestMailbox() {
+        delete slot.exchange(nullptr);
+    }
+    LatestMailbox(const LatestMailbox&) = delete;
+    LatestMailbox &operator=(const LatestMailbox&) = delete;
+
+    // Returns true when there is no active consumer and the caller
+    // is responsible for starting one.
+    bool post(T value, quint64 *postedGeneration = nullptr) {
+        Entry *entry = new Entry { std::move(value), generation.load() + 1 };
+        generation.store(entry->generation);
+        delete slot.exchange(entry); // drop the one nobody picked up
+        if(postedGeneration)
+            *postedGeneration = entry->generation;
+        return !busy.exchange(true);
+    }
+
+    bool take(T &value, quint64 &valueGeneration) {
+        Entry *entry = slot.exchange(nullptr);
+        if(!entry)
+            return false;
+        value = std::move(entry->value);
+        valueGeneration = entry->generation;
+        delete entry;
+        return true;
+    }
+
+    // Called by consumer once take() returns false.
+    // Returns true if something arrived in the meantime and the same
+    // consumer should keep going.
+    bool finish() {
+        busy.store(false);
+        return slot.load() && !busy.exchange(true);
+    }
+
+    bool isCurrent(quint64 valueGeneration) const {
+        return valueGeneration == generation.load();
+    }
+
+    quint64 currentGeneration() const {
+        return generation.load();
+    }
+
+private:
+    struct Entry {
+        T value;
+        quint64 generation;
+    };
+    std::atomic<Entry*> slot;
+    std::atomic<quint64> generation;
+    std::atomic<bool> busy;
+};